@@ -3,8 +3,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-
-# define INT_BUFFER 128
+#include <errno.h>
 
 // ================================================
 // Basic struct definitions from ex6.h assumed:
@@ -20,10 +19,14 @@
 // --------------------------------------------------------------
 
 void freeOwnerNode(OwnerNode *owner) {
+    // leave the inverted index before the owner goes away
+    clearOwnerMasks(owner);
     free(owner->ownerName);
     owner->ownerName = NULL;
-    recursivelyFreePokemonNodes(owner->pokedexRoot);
+    // every node lives in the arena, so this drops the whole tree
+    releaseArena(&owner->arena);
     owner->pokedexRoot = NULL;
+    pthread_rwlock_destroy(&owner->lock);
     free(owner);
     owner = NULL;
 }
@@ -39,1187 +42,3781 @@ void freeAllOwners() {
         freeOwnerNode(temp);
     } while (current != ownerHead);
     ownerHead = NULL;
+    freeOwnerRegistry();
+    freeOwnerDirectory();
+    freeSpeciesHolders();
 }
 
 void printOwnersCircular() {
     // first: if no owners, print message and return
     if (ownerHead == NULL) {
-        printf("No owners.\n");
+        outPrintf("No owners.\n");
         return;
     }
 
     // get direction from user
-    printf("Enter direction (F or B): ");
-    OwnerNode *temp = ownerHead;
+    printPrompt("Enter direction (F or B): ");
     char *choice = getDynamicInput();
     if (!choice) {
-        printf("Memory allocation failed.\n");
+        outPrintf("Memory allocation failed.\n");
         return;
     }
 
-    // validate input
+    // validate input (stop asking once input has run out)
     while (!strchr(choice, 'F') && !strchr(choice, 'f') &&
             !strchr(choice, 'B') && !strchr(choice, 'b')) {
-        printf("Invalid direction, must be F or B.\n");
-        printf("Enter direction (F or B): ");
+        if (inputExhausted) {
+            free(choice);
+            return;
+        }
+        outPrintf("Invalid direction, must be F or B.\n");
+        printPrompt("Enter direction (F or B): ");
         free(choice);
         choice = getDynamicInput();
         if (!choice) {
-            printf("Memory allocation failed.\n");
+            outPrintf("Memory allocation failed.\n");
             return;
         }
     }
 
     // get number of prints from user
     int numPrints = readIntSafe("How many prints? ");
+    if (inputExhausted) {
+        free(choice);
+        return;
+    }
+
+    printOwnersInDirection(strchr(choice, 'F') || strchr(choice, 'f'), numPrints);
+    // free choice before exit
+    free(choice);
+}
 
+void printOwnersInDirection(int forward, int numPrints) {
+    OwnerNode *temp = ownerHead;
     // case of less than 1: no prints
-    if (numPrints < 1) {
-        free(choice);
+    if (numPrints < 1 || temp == NULL) {
         return;
     }
 
     // print in said direction
-    if (strchr(choice, 'F') || strchr(choice, 'f')) {
+    if (forward) {
         // print all owners
         for (int i = 0; i < numPrints; i++) {
-            printf("[%d] %s\n", i + 1, temp->ownerName);
+            outWrite("[", 1);
+            outInt(i + 1);
+            outWrite("] ", 2);
+            outString(temp->ownerName);
+            outWrite("\n", 1);
             temp = temp->next;
         }
     } else {
         // print all owners in reverse
         for (int i = 0; i < numPrints; i++) {
-            printf("[%d] %s\n", i + 1, temp->ownerName);
+            outWrite("[", 1);
+            outInt(i + 1);
+            outWrite("] ", 2);
+            outString(temp->ownerName);
+            outWrite("\n", 1);
             temp = temp->prev;
         }
     }
-    // free choice before exit
-    free(choice);
 }
 
 void sortOwners() {
     // edge case: 0 or 1 owners:
     if (ownerHead == NULL || ownerHead->next == ownerHead) {
-        printf("0 or 1 owners only => no need to sort.\n");
+        outPrintf("0 or 1 owners only => no need to sort.\n");
         return;
     }
-    // bubble sort on circular list
-    int amountOfOwners = 1;
-    OwnerNode *temp = ownerHead;
-    while (temp->next != ownerHead) {
-        amountOfOwners++;
-        temp = temp->next;
-    }
-
-    // bubble sort on circular list
-    for (int i = 0; i < amountOfOwners - 1; i++) {
-        OwnerNode *current = ownerHead;
-        for (int j = 0; j < amountOfOwners - i - 1; j++) {
-            if (strcmp(current->ownerName, current->next->ownerName) > 0) {
-                swapOwnerData(current, current->next);
-            }
-            current = current->next;
-        }
-    }
-    printf("Owners sorted by name.\n");
+    applySortOwners();
+    outPrintf("Owners sorted by name.\n");
 }
 
-void swapOwnerData(OwnerNode *a, OwnerNode *b) {
-    // Swap the owner name and pokedexRoot
-    char *tempName = a->ownerName;
-    PokemonNode *tempPokedexRoot = a->pokedexRoot;
+OwnerNode *mergeSortOwnerList(OwnerNode *head) {
+    if (head == NULL || head->next == NULL) {
+        return head;
+    }
+    // split in the middle: slow stops at the end of the first half
+    OwnerNode *slow = head;
+    OwnerNode *fast = head->next;
+    while (fast != NULL && fast->next != NULL) {
+        slow = slow->next;
+        fast = fast->next->next;
+    }
+    OwnerNode *secondHalf = slow->next;
+    slow->next = NULL;
 
-    a->ownerName = b->ownerName;
-    a->pokedexRoot = b->pokedexRoot;
+    OwnerNode *left = mergeSortOwnerList(head);
+    OwnerNode *right = mergeSortOwnerList(secondHalf);
 
-    b->ownerName = tempName;
-    b->pokedexRoot = tempPokedexRoot;
+    // merge, taking from the left on ties so equal names keep their order
+    OwnerNode *merged = NULL;
+    OwnerNode **tail = &merged;
+    while (left != NULL && right != NULL) {
+        if (strcmp(left->ownerName, right->ownerName) <= 0) {
+            *tail = left;
+            left = left->next;
+        } else {
+            *tail = right;
+            right = right->next;
+        }
+        tail = &((*tail)->next);
+    }
+    *tail = (left != NULL) ? left : right;
+    return merged;
 }
 
 OwnerNode *findOwnerByName(const char *nameToFind) {
-    if (ownerHead == NULL) {
+    if (ownerRegistry.size == 0) {
         return NULL;
     }
-    OwnerNode *temp = ownerHead;
-    do {
-        if (strcmp(temp->ownerName, nameToFind) == 0) {
+    unsigned int hash = hashOwnerName(nameToFind);
+    OwnerNode *temp = ownerRegistry.buckets[hash & (unsigned int)(ownerRegistry.bucketCount - 1)];
+    while (temp != NULL) {
+        // compare the cached hash first, strcmp only on a real candidate
+        if (temp->nameHash == hash && strcmp(temp->ownerName, nameToFind) == 0) {
             return temp;
         }
-        temp = temp->next;
-    } while (temp != ownerHead);
+        temp = temp->hashNext;
+    }
     return NULL;
 }
 
+unsigned int hashOwnerName(const char *name) {
+    // 32-bit FNV-1a
+    unsigned int hash = 2166136261u;
+    for (const unsigned char *c = (const unsigned char *)name; *c != '\0'; c++) {
+        hash ^= *c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void growOwnerRegistry(void) {
+    int newCount = (ownerRegistry.bucketCount == 0) ? OWNER_REGISTRY_INITIAL_BUCKETS : ownerRegistry.bucketCount * 2;
+    OwnerNode **newBuckets = calloc((size_t)newCount, sizeof(OwnerNode *));
+    if (newBuckets == NULL) {
+        // keep the old table, lookups still work, just with longer chains
+        return;
+    }
+    // rehash with the cached hashes, no string work
+    for (int i = 0; i < ownerRegistry.bucketCount; i++) {
+        OwnerNode *temp = ownerRegistry.buckets[i];
+        while (temp != NULL) {
+            OwnerNode *next = temp->hashNext;
+            unsigned int bucket = temp->nameHash & (unsigned int)(newCount - 1);
+            temp->hashNext = newBuckets[bucket];
+            newBuckets[bucket] = temp;
+            temp = next;
+        }
+    }
+    free(ownerRegistry.buckets);
+    ownerRegistry.buckets = newBuckets;
+    ownerRegistry.bucketCount = newCount;
+}
+
+void registerOwner(OwnerNode *owner) {
+    if ((ownerRegistry.size + 1) * 4 > ownerRegistry.bucketCount * 3) {
+        growOwnerRegistry();
+        if (ownerRegistry.bucketCount == 0) {
+            outPrintf("Memory allocation failed.\n");
+            return;
+        }
+    }
+    owner->nameHash = hashOwnerName(owner->ownerName);
+    unsigned int bucket = owner->nameHash & (unsigned int)(ownerRegistry.bucketCount - 1);
+    owner->hashNext = ownerRegistry.buckets[bucket];
+    ownerRegistry.buckets[bucket] = owner;
+    ownerRegistry.size++;
+}
+
+void unregisterOwner(OwnerNode *owner) {
+    if (ownerRegistry.bucketCount == 0) {
+        return;
+    }
+    OwnerNode **link = &ownerRegistry.buckets[owner->nameHash & (unsigned int)(ownerRegistry.bucketCount - 1)];
+    while (*link != NULL) {
+        if (*link == owner) {
+            *link = owner->hashNext;
+            owner->hashNext = NULL;
+            ownerRegistry.size--;
+            return;
+        }
+        link = &((*link)->hashNext);
+    }
+}
+
+void freeOwnerRegistry(void) {
+    free(ownerRegistry.buckets);
+    ownerRegistry.buckets = NULL;
+    ownerRegistry.bucketCount = 0;
+    ownerRegistry.size = 0;
+}
+
 void mergePokedexMenu() {
     // first - if less than two owners
     if (ownerHead == NULL || ownerHead->next == ownerHead) {
-        printf("Not enough owners to merge.\n");
+        outPrintf("Not enough owners to merge.\n");
         return;
     }
 
     // ask to enter names
-    printf("\n=== Merge Pokedexes ===\n");
-    printf("Enter name of first owner: ");
+    printPrompt("\n=== Merge Pokedexes ===\n");
+    printPrompt("Enter name of first owner: ");
     char *firstUser = getDynamicInput();
     if (!firstUser) {
-        printf("Memory allocation failed.\n");
+        outPrintf("Memory allocation failed.\n");
         return;
     }
-    printf("Enter name of second owner: ");
+    printPrompt("Enter name of second owner: ");
     char *secondUser = getDynamicInput();
     if (!secondUser) {
-        printf("Memory allocation failed.\n");
+        outPrintf("Memory allocation failed.\n");
         free(firstUser);
         return;
     }
-    printf("Merging %s and %s...\n", firstUser, secondUser);
+    if (!inputExhausted) {
+        mergePokedexesOf(firstUser, secondUser);
+    }
+    free(firstUser);
+    free(secondUser);
+}
+
+void mergePokedexesOf(const char *firstUser, const char *secondUser) {
+    outPrintf("Merging %s and %s...\n", firstUser, secondUser);
 
     // find the two owners
     OwnerNode *firstOwner = findOwnerByName(firstUser);
     OwnerNode *secondOwner = findOwnerByName(secondUser);
 
-    if (!firstOwner || !secondOwner) {return;}
-
-    // BFS on second user, for each node add it to first - normal insertion
-    // use same queue as evolve
-    PokedexQueue *queue = malloc(sizeof(PokedexQueue));
-    if (!queue) {
-        printf("Memory allocation failed.\n");
-        return;
-    }
-    // put root into queue
-    PokedexQueueNode *firstNode = createQueueNode(secondOwner->pokedexRoot);
-    queue->front = firstNode;
-    queue->rear = firstNode;
-    while (queue->front) {
-        // add children to queue
-        PokedexQueueNode *current = queue->front;
-        if (current->data->left) {
-            PokedexQueueNode *tempLeft = createQueueNode(current->data->left);
-            queue->rear->next = tempLeft;
-            queue->rear = tempLeft;
-        }
-        if (current->data->right) {
-            PokedexQueueNode *tempRight = createQueueNode(current->data->right);
-            queue->rear->next = tempRight;
-            queue->rear = tempRight;
-        }
-        // add current to first owner
-        addPKMNToBST(firstOwner->pokedexRoot, current->data->data->id);
-        // remove from queue and free
-        PokedexQueueNode *temp = queue->front;
-        queue->front = queue->front->next;
-        free(temp);
-    }
-    free(queue);
-
-    // now use delete owner logic to remove second
-    // first - free entire pokemon tree
-    recursivelyFreePokemonNodes(secondOwner->pokedexRoot);
-    // then free owner name
-    free(secondOwner->ownerName);
-    // then connect two surrounding nodes
-    secondOwner->prev->next = secondOwner->next;
-    secondOwner->next->prev = secondOwner->prev;
-    // account for if this is the global head
-    if (secondOwner == ownerHead) {
-        ownerHead = secondOwner->next;
-    }
-    // then free itself
-    free(secondOwner);
-
-    printf("Merge completed.\n");
-    printf("Owner '%s' has been removed after merging.\n", secondUser);
-
-    free(firstUser);
-    free(secondUser);
-
-}
-
-void deletePokedex() {
-    // edge case: 0 owners
-    if (ownerHead == NULL) {
-        printf("No existing Pokedexes to delete.\n");
+    if (!firstOwner || !secondOwner || firstOwner == secondOwner) {
         return;
     }
 
-    printf("\n=== Delete a Pokedex ===\n");
-
-    // print by looping through each owner - while doesn't equal head, print next etc
-    printAllOwners();
-
-    // get user input for which owner by list number starting at 1
-    int ownerChoice = readIntSafe("Choose a Pokedex to delete by number: ");
-    OwnerNode *cur = ownerHead;
-    if (ownerChoice > 1) {
-        for (int i = 1; i < ownerChoice; i++) {
-            cur = cur->next;
-        }
-    }
-    printf("Deleting %s's entire Pokedex...\n", cur->ownerName);
-
-    // account for if this is the global head
-    if (cur == ownerHead) {
-        ownerHead = cur->next;
-    }
-
-    // first - free entire pokemon tree
-    recursivelyFreePokemonNodes(cur->pokedexRoot);
-    recursivelyCleanNullPokemon(&cur->pokedexRoot);
-    // then free owner name
-    free(cur->ownerName);
-    cur->ownerName = NULL;
-    // then connect two surrounding nodes
-    cur->prev->next = cur->next;
-    cur->next->prev = cur->prev;
-    // then free itself
-    free(cur);
-    cur = NULL;
+    // union both sorted sequences into the first owner, then delete the second
+    applyMergeOwners(firstOwner, secondOwner);
 
-    printf("Pokedex deleted.\n");
+    outPrintf("Merge completed.\n");
+    outPrintf("Owner '%s' has been removed after merging.\n", secondUser);
 }
 
-void evolvePokemon(OwnerNode *owner) {
-    int IDToEvolve = readIntSafe("Enter ID of Pokemon to evolve: ");
-    // find ID in BST - if exists, if not, NULL
-    PokemonNode *pokemonToEvolve = searchPokemonBFS(owner->pokedexRoot, IDToEvolve);
-    // if pokemon not in tree - print message and done
-    if (pokemonToEvolve == NULL) {
-        printf("No Pokemon with ID %d found.\n", IDToEvolve);
-        return;
-    }
-    // if pokemon in tree, but cant evolve - print message and done
-    if (pokemonToEvolve->data->CAN_EVOLVE == CANNOT_EVOLVE) {
-        printf("%s (ID %d) cannot evolve.\n", pokemonToEvolve->data->name, IDToEvolve);
+void bulkMergePokedexMenu() {
+    // first - if less than two owners
+    if (ownerHead == NULL || ownerHead->next == ownerHead) {
+        outPrintf("Not enough owners to merge.\n");
         return;
     }
-    // otherwise, can evolve, so remove ID from tree, and add ID + 1 to tree
-    freePokemonHelper(&(owner->pokedexRoot), IDToEvolve);
-    printf("Removing Pokemon %s (ID %d).\n", pokedex[IDToEvolve - 1].name, IDToEvolve);
-    addPKMNToBST(owner->pokedexRoot, IDToEvolve + 1);
-    printf("Pokemon evolved from %s (ID %d) to %s (ID %d).\n", pokedex[IDToEvolve - 1].name, IDToEvolve, pokedex[IDToEvolve].name, IDToEvolve + 1);
-}
 
-void pokemonFight(OwnerNode *owner) {
-    int ID1 = readIntSafe("Enter ID of the first Pokemon: ");
-    int ID2 = readIntSafe("Enter ID of the second Pokemon: ");
-    PokemonNode *pokemon1 = searchPokemonBFS(owner->pokedexRoot, ID1);
-    PokemonNode *pokemon2 = searchPokemonBFS(owner->pokedexRoot, ID2);
-    if (pokemon1 == NULL || pokemon2 == NULL) {
-        printf("One or both Pokemon IDs not found.\n");
+    printPrompt("\n=== Merge Many Pokedexes ===\n");
+    printPrompt("Enter name of the owner to merge into: ");
+    char *targetName = getDynamicInput();
+    if (!targetName) {
+        outPrintf("Memory allocation failed.\n");
         return;
     }
-    float attack1 = ((float)pokemon1->data->attack * (float)ATTACK_MODIFIER) + ((float)pokemon1->data->hp * (float)HP_MODIFIER);
-    float attack2 = ((float)pokemon2->data->attack * (float)ATTACK_MODIFIER) + ((float)pokemon2->data->hp * (float)HP_MODIFIER);
-    printf("Pokemon 1: %s (Score = %.2f)\n", pokemon1->data->name, attack1);
-    printf("Pokemon 2: %s (Score = %.2f)\n", pokemon2->data->name, attack2);
-
-    if (attack1 > attack2) {
-        printf("%s wins!\n", pokemon1->data->name);
+    printPrompt("Enter names of the owners to merge in (comma-separated): ");
+    char *sourceNames = getDynamicInput();
+    if (!sourceNames) {
+        outPrintf("Memory allocation failed.\n");
+        free(targetName);
         return;
     }
-    if (attack2 > attack1) {
-        printf("%s wins!\n", pokemon2->data->name);
-        return;
+    if (!inputExhausted) {
+        bulkMergePokedexesInto(targetName, sourceNames);
     }
-    printf("It's a tie!\n");
+    free(targetName);
+    free(sourceNames);
 }
 
-void insertPokemonNode(PokemonNode **root, PokemonNode *newNode) {
-    if (newNode == NULL || newNode->data == NULL) {
+void bulkMergePokedexesInto(const char *targetName, char *sourceNames) {
+    OwnerNode *target = findOwnerByName(targetName);
+    if (target == NULL) {
+        outPrintf("Owner '%s' not found.\n", targetName);
         return;
     }
-    if (*root == NULL) {
-        *root = newNode;
+    // at most every other owner can be a source; chosen[position] catches repeats
+    OwnerNode **sources = malloc((size_t)ownerDirectory.count * sizeof(OwnerNode *));
+    unsigned char *chosen = calloc((size_t)ownerDirectory.count, 1);
+    if (sources == NULL || chosen == NULL) {
+        outPrintf("Memory allocation failed.\n");
+        free(sources);
+        free(chosen);
         return;
     }
-    if (newNode->data->id < (*root)->data->id) {
-        insertPokemonNode(&((*root)->left), newNode);
-    } else if (newNode->data->id > (*root)->data->id) {
-        insertPokemonNode(&((*root)->right), newNode);
-    }
-}
+    chosen[target->position] = 1;
 
-void recursivelyFreePokemonNodes(PokemonNode *root) {
-    if (root == NULL) {
-        return;
+    int count = 0;
+    char *name = sourceNames;
+    while (name != NULL) {
+        char *comma = strchr(name, ',');
+        if (comma != NULL) {
+            *comma = '\0';
+        }
+        trimWhitespace(name);
+        if (*name != '\0') {
+            OwnerNode *source = findOwnerByName(name);
+            if (source == NULL) {
+                outPrintf("Owner '%s' not found, skipped.\n", name);
+            } else if (!chosen[source->position]) {
+                chosen[source->position] = 1;
+                sources[count++] = source;
+            }
+        }
+        name = (comma != NULL) ? comma + 1 : NULL;
     }
-    // free children first
-    if (root->left != NULL) {
-        recursivelyFreePokemonNodes(root->left);
+    free(chosen);
+    if (count == 0) {
+        outPrintf("Nothing to merge.\n");
+        free(sources);
+        return;
     }
-    if (root->right != NULL) {
-        recursivelyFreePokemonNodes(root->right);
+
+    outPrintf("Merging %d owner(s) into %s...\n", count, target->ownerName);
+    if (!applyBulkMerge(target, sources, count)) {
+        free(sources);
+        return;
     }
-    // free current node
-    // at this point, already called recursively, so right and left can be freed too
-    free(root->data->name);
-    root->data->name = NULL;
-    free(root->data);
-    root->data = NULL;
-    free(root);
-    root = NULL;
+    free(sources);
+    outPrintf("Merge completed.\n");
+    outPrintf("%d owner(s) have been removed after merging.\n", count);
 }
 
-PokemonNode *searchPokemonBFS(PokemonNode *root, int ID) {
-    if (root == NULL) {
+OwnerNode *getOwnerByNumber(int listNumber) {
+    if (ownerDirectory.count == 0) {
         return NULL;
     }
-    if (ID > root->data->id) {
-        return searchPokemonBFS(root->right, ID);
-    }
-    if (ID < root->data->id) {
-        return searchPokemonBFS(root->left, ID);
-    }
-    if (ID == root->data->id) {
-        return root;
+    // same result as walking next from the head: anything below 1 is the head, wrap past the end
+    // (checked before subtracting, so INT_MIN can't overflow)
+    if (listNumber < 1) {
+        return ownerDirectory.owners[0];
     }
-    return NULL;
+    return ownerDirectory.owners[(listNumber - 1) % ownerDirectory.count];
 }
 
-void freePokemonNode(PokemonNode **pokemonInTree, int IDToRelease) {
-        // create a list of all sub children ID's
-        // recursively free everyone
-        // then from smallest value of list (which is what should replace current)
-        // copy ID to current location
-        // then iteratively through the list of ids, add them to the tree standard node creation
-        int amountOfPokemon = countNodesInTree((*pokemonInTree));
-        int *allIDS = (int *)malloc(amountOfPokemon * sizeof(int));
-        if (!allIDS) {
-            printf("Memory allocation failed.\n");
-            return;
-        }
-        //make queue to get ID's in proper order
-        IDQueue *queue = malloc(sizeof(IDQueue));
-        if (!queue) {
-            printf("Memory allocation failed.\n");
-            return;
-        }
-        // add all ID's to list and free all nodes
-        if ((*pokemonInTree)->left != NULL) {
-            IDQueueNode *firstLeft = malloc(sizeof(IDQueueNode));
-            if (!firstLeft) {
-                printf("Memory allocation failed.\n");
-                return;
-            }
-            firstLeft->data = (*pokemonInTree)->left->data->id;
-            queue->front = firstLeft;
-            queue->rear = firstLeft;
-        }
-        if ((*pokemonInTree)->right != NULL) {
-            IDQueueNode *firstRight = malloc(sizeof(IDQueueNode));
-            if (!firstRight) {
-                printf("Memory allocation failed.\n");
-                return;
-            }
-            firstRight->data = (*pokemonInTree)->right->data->id;
-            if (!queue->front || !queue->rear) {
-                queue->front = firstRight;
-                queue->rear = firstRight;
-            } else {
-                queue->rear->next = firstRight;
-                queue->rear = firstRight;
-            }
-        }
-        int locIDAdd = 0;
-        // add all ID's to list and free nodes:
-        while (queue->front) {
-            // add ID to list, add children to queue, free
-            IDQueueNode *current = queue->front;
-            allIDS[locIDAdd] = current->data;
-            locIDAdd++;
-            // always add left child first
-            PokemonNode *currentNode = searchPokemonBFS((*pokemonInTree), current->data);
-            if (currentNode->left != NULL) {
-                IDQueueNode *tempLeft = malloc(sizeof(IDQueueNode));
-                if (!tempLeft) {
-                    printf("Memory allocation failed.\n");
-                    return;
-                }
-                tempLeft->data = currentNode->left->data->id;
-                queue->rear->next = tempLeft;
-                queue->rear = tempLeft;
-            }
-            if (currentNode->right != NULL) {
-                IDQueueNode *tempRight = malloc(sizeof(IDQueueNode));
-                if (!tempRight) {
-                    printf("Memory allocation failed.\n");
-                    return;
-                }
-                tempRight->data = currentNode->right->data->id;
-                queue->rear->next = tempRight;
-                queue->rear = tempRight;
-            }
-            // free current Queue node
-            queue->front = queue->front->next;
-            free(current);
-        }
-
-        // now all IDs in list, so free all children recursively
-        recursivelyFreePokemonNodes((*pokemonInTree));
-
-        // now, find smallest greater ID in list, and copy it to current location
-        // first set smallest greater to higher than num pokemon, so we can find smallest
-        int smallestGreaterID = AMOUNT_OF_POKEMON;
-        for (int i = 0; i < amountOfPokemon; i++) {
-            if (allIDS[i] > IDToRelease && allIDS[i] < smallestGreaterID) {
-                smallestGreaterID = allIDS[i];
-            }
-        }
-        PokemonNode *newSubTree = NULL;
-        // if smallest greater is not AMOUNT_OF_POKEMON, then copy it to current location
-        if (smallestGreaterID != AMOUNT_OF_POKEMON) {
-            newSubTree = createPokemonNode(copyPokedexEntryByID(smallestGreaterID - 1));
-            newSubTree->left = NULL;
-            newSubTree->right = NULL;
-        }
-        for (int i = 0; i < amountOfPokemon - 1; i++) {
-            if (allIDS[i] != smallestGreaterID) {
-                // add all other ID's to tree
-                if (newSubTree == NULL) {
-                    newSubTree = createPokemonNode(copyPokedexEntryByID(allIDS[i] - 1));
-                    newSubTree->left = NULL;
-                    newSubTree->right = NULL;
-                } else {
-                    insertPokemonNode(&newSubTree, createPokemonNode(copyPokedexEntryByID(allIDS[i] - 1)));
-                }
-            }
+static int appendToOwnerDirectory(OwnerNode *owner) {
+    if (ownerDirectory.count == ownerDirectory.capacity) {
+        int newCapacity = (ownerDirectory.capacity == 0) ? OWNERS_PAGE_SIZE : ownerDirectory.capacity * 2;
+        OwnerNode **temp = realloc(ownerDirectory.owners, (size_t)newCapacity * sizeof(OwnerNode *));
+        if (temp == NULL) {
+            outPrintf("Memory allocation failed.\n");
+            return 0;
         }
-
-        *pokemonInTree = newSubTree;
-
-        // free used date:
-        free(queue);
-        free(allIDS);
+        ownerDirectory.owners = temp;
+        ownerDirectory.capacity = newCapacity;
+    }
+    owner->position = ownerDirectory.count;
+    ownerDirectory.owners[ownerDirectory.count] = owner;
+    ownerDirectory.count++;
+    return 1;
 }
 
-void freePokemonHelper(PokemonNode **pokemonInTree, int IDToRelease) {
-    // case 1: ID == currentNodeID => got it, free pokemon
-    if (IDToRelease == (*pokemonInTree)->data->id) {
+void rebuildOwnerDirectory(void) {
+    ownerDirectory.count = 0;
+    if (ownerHead == NULL) {
+        return;
+    }
+    OwnerNode *temp = ownerHead;
+    do {
+        appendToOwnerDirectory(temp);
+        temp = temp->next;
+    } while (temp != ownerHead);
+}
 
-        printf("Removing Pokemon %s (ID %d).\n", (*pokemonInTree)->data->name, IDToRelease);
+void freeOwnerDirectory(void) {
+    free(ownerDirectory.owners);
+    ownerDirectory.owners = NULL;
+    ownerDirectory.count = 0;
+    ownerDirectory.capacity = 0;
+}
 
-        // case: no children to worry about assigning - just free it in place now
-        if (((*pokemonInTree)->left == NULL) && ((*pokemonInTree)->right == NULL)) {
-            free((*pokemonInTree)->data->name);
-            (*pokemonInTree)->data->name = NULL;
-            free((*pokemonInTree)->data);
-            (*pokemonInTree)->data = NULL;
-            free(*pokemonInTree);
-            *pokemonInTree = NULL;
+void addSpeciesHolder(OwnerNode *owner, int id) {
+    SpeciesHolders *holders = &speciesHolders[id];
+    // owners changed in parallel may hold the same species
+    pthread_mutex_lock(&holdersLock);
+    if (holders->count == holders->capacity) {
+        int capacity = (holders->capacity == 0) ? 4 : holders->capacity * 2;
+        OwnerNode **grown = realloc(holders->owners, (size_t)capacity * sizeof(OwnerNode *));
+        if (grown == NULL) {
+            owner->holderSlot[id] = -1;
+            pthread_mutex_unlock(&holdersLock);
+            outPrintf("Memory allocation failed.\n");
             return;
         }
-
-        // otherwise, neeed to handle children, so:
-        // call freePokemonNode which has the logic to free it and handle children
-        freePokemonNode(pokemonInTree, IDToRelease);
-
-        return;
-    }
-    // case 2: both children are null => return failure
-    if (((*pokemonInTree)->left == NULL) && ((*pokemonInTree)->right == NULL)) {
-        printf("No Pokemon with ID %d found.", IDToRelease);
-        return;
-    }
-    // case 3: ID > currentNodeID => go right
-    if (IDToRelease > (*pokemonInTree)->data->id) {
-        return freePokemonHelper(&((*pokemonInTree)->right), IDToRelease);
+        holders->owners = grown;
+        holders->capacity = capacity;
     }
-    // case 4: ID < currentNodeID => go left
-    return freePokemonHelper(&((*pokemonInTree)->left), IDToRelease);
-
+    owner->holderSlot[id] = holders->count;
+    holders->owners[holders->count++] = owner;
+    pthread_mutex_unlock(&holdersLock);
 }
 
-void freePokemon(OwnerNode *owner) {
-    int choiceOfIDToFree = readIntSafe("Enter Pokemon ID to release: ");
-    // call recursive function to find if ID exists in tree and free it
-    freePokemonHelper(&owner->pokedexRoot, choiceOfIDToFree);
+void removeSpeciesHolder(OwnerNode *owner, int id) {
+    SpeciesHolders *holders = &speciesHolders[id];
+    pthread_mutex_lock(&holdersLock);
+    int slot = owner->holderSlot[id];
+    if (slot >= 0) {
+        // fill the hole with the last holder
+        OwnerNode *last = holders->owners[--holders->count];
+        holders->owners[slot] = last;
+        last->holderSlot[id] = slot;
+        owner->holderSlot[id] = -1;
+    }
+    pthread_mutex_unlock(&holdersLock);
 }
 
-int countNodesInTree(PokemonNode *root) {
-    if (root == NULL) {
-        return 0;
+void freeSpeciesHolders(void) {
+    for (int id = 1; id <= AMOUNT_OF_POKEMON; id++) {
+        free(speciesHolders[id].owners);
+        speciesHolders[id].owners = NULL;
+        speciesHolders[id].count = 0;
+        speciesHolders[id].capacity = 0;
     }
-    return 1 + countNodesInTree(root->left) + countNodesInTree(root->right);
 }
 
-void displayAlphabetical(PokemonNode *root, VisitNodeFunc visit) {
-    // initialize NodeArray struct
-    int numNodes = countNodesInTree(root);
-    NodeArray *nodeArray = (NodeArray*)malloc(sizeof(NodeArray));
-    if (!nodeArray) {
-        printf("Memory allocation failed.\n");
+void findOwnersOfPokemon(void) {
+    int id = readIntSafe("Enter Pokemon ID: ");
+    if (inputExhausted) {
         return;
     }
-    initNodeArray(nodeArray, numNodes);
-    // add all nodes, regardless of order, into array
-    // don't need to worry about reallc, as counted nodes first and made it to size
-    collectAll(root, nodeArray);
-    // run bubble sort on array
-    qsort(nodeArray->nodes, nodeArray->size, sizeof(PokemonNode*), compareByNameNode);
+    printHoldersOf(id);
+}
 
-    for (int i = 0; i < nodeArray->size; i++) {
-        visit(nodeArray->nodes[i]);
+void printHoldersOf(int id) {
+    if (id <= 0 || id > AMOUNT_OF_POKEMON) {
+        outPrintf("Invalid ID.\n");
+        return;
+    }
+    const SpeciesHolders *holders = &speciesHolders[id];
+    if (holders->count == 0) {
+        outPrintf("Nobody has %s (ID %d).\n", pokedex[id - 1].name, id);
+        return;
+    }
+    outPrintf("%s (ID %d) is owned by %d owner(s):\n", pokedex[id - 1].name, id, holders->count);
+    for (int i = 0; i < holders->count; i++) {
+        outWrite("- ", 2);
+        outString(holders->owners[i]->ownerName);
+        outWrite("\n", 1);
     }
-
-    free(nodeArray->nodes);
-    free(nodeArray);
 }
 
-int compareByNameNode(const void *a, const void *b) {
-    // run strcmp on our two strings for qsort compare
-    return strcmp((*(PokemonNode**)a)->data->name, (*(PokemonNode**)b)->data->name);
+int compareByHolderCount(const void *a, const void *b) {
+    int first = *(const int *)a;
+    int second = *(const int *)b;
+    if (speciesHolders[first].count != speciesHolders[second].count) {
+        return speciesHolders[first].count - speciesHolders[second].count;
+    }
+    return first - second;
 }
 
-void collectAll(PokemonNode *root, NodeArray *na) {
-    // add node to Array, then recursively add left and right children
-    na->nodes[na->size] = root;
-    na->size++;
-    if (root->left) {
-        collectAll(root->left, na);
+void printRarityReport(void) {
+    // species somebody has, rarest first
+    int held[AMOUNT_OF_POKEMON];
+    int heldCount = 0;
+    for (int id = 1; id <= AMOUNT_OF_POKEMON; id++) {
+        if (speciesHolders[id].count > 0) {
+            held[heldCount++] = id;
+        }
+    }
+    if (heldCount == 0) {
+        outPrintf("No Pokemon owned yet.\n");
+        return;
     }
-    if (root->right) {
-        collectAll(root->right, na);
+    qsort(held, (size_t)heldCount, sizeof(int), compareByHolderCount);
+    outPrintf("\n=== Rarity Report ===\n");
+    for (int i = 0; i < heldCount; i++) {
+        int id = held[i];
+        outPrintf("%s (ID %d): %d owner(s)\n", pokedex[id - 1].name, id, speciesHolders[id].count);
     }
+    outPrintf("Species nobody has: %d\n", AMOUNT_OF_POKEMON - heldCount);
 }
 
-void initNodeArray(NodeArray *na, int cap) {
-    // initialize array and set capacity to size of array
-    na->nodes = malloc(cap * sizeof(PokemonNode*));
-    na->capacity = cap;
-    // initialize current size/amount of nodes added to zero
-    na->size = 0;
+void linkOwnerInCircularList(OwnerNode *newOwner) {
+    // if it's the first, set its location to itself
+    if (ownerHead == NULL) {
+        ownerHead = newOwner;
+        ownerHead->next = ownerHead;
+        ownerHead->prev = ownerHead;
+    } else {
+    // otherwise slip it in before the head / in last place in the circle
+        OwnerNode *lastNode = ownerHead->prev;
+        lastNode->next = newOwner;
+        newOwner->prev = lastNode;
+        newOwner->next = ownerHead;
+        ownerHead->prev = newOwner;
+    }
+    registerOwner(newOwner);
+    // last in the circle => last list number
+    appendToOwnerDirectory(newOwner);
 }
 
-void postOrderTraversal(PokemonNode *root, VisitNodeFunc visit) {
-    // post order visits bottom node from left path first, then right, then back to root
-    // recursively visit left
-    if (root->left) {
-        postOrderTraversal(root->left, visit);
+void removeOwnerFromCircularList(OwnerNode *target) {
+    unregisterOwner(target);
+    // everyone after the target moves up one list number
+    int position = target->position;
+    if (position < ownerDirectory.count && ownerDirectory.owners[position] == target) {
+        memmove(&ownerDirectory.owners[position], &ownerDirectory.owners[position + 1],
+                (size_t)(ownerDirectory.count - position - 1) * sizeof(OwnerNode *));
+        ownerDirectory.count--;
+        for (int i = position; i < ownerDirectory.count; i++) {
+            ownerDirectory.owners[i]->position = i;
+        }
     }
-    // recursively visit right
-    if (root->right) {
-        postOrderTraversal(root->right, visit);
+    // account for if this is the global head (or the only owner left)
+    if (target->next == target) {
+        ownerHead = NULL;
+    } else {
+        if (target == ownerHead) {
+            ownerHead = target->next;
+        }
+        // connect two surrounding nodes
+        target->prev->next = target->next;
+        target->next->prev = target->prev;
     }
-    // visit root
-    visit(root);
+    target->next = NULL;
+    target->prev = NULL;
 }
 
-void inOrderTraversal(PokemonNode *root, VisitNodeFunc visit) {
-    // in order visits bottom node from left path first, then back to root, then right, then back
-    // recursively visit left
-    if (root->left) {
-        inOrderTraversal(root->left, visit);
+void deletePokedex() {
+    // edge case: 0 owners
+    if (ownerHead == NULL) {
+        outPrintf("No existing Pokedexes to delete.\n");
+        return;
     }
-    // visit root
-    visit(root);
-    // recursively visit right
-    if (root->right) {
-        inOrderTraversal(root->right, visit);
+
+    printPrompt("\n=== Delete a Pokedex ===\n");
+
+    // get user input for which owner by list number starting at 1
+    int ownerChoice = readOwnerChoice("Choose a Pokedex to delete by number: ");
+    if (inputExhausted) {
+        return;
     }
+    deletePokedexOf(getOwnerByNumber(ownerChoice));
 }
 
-void preOrderTraversal(PokemonNode *root, VisitNodeFunc visit) {
-    // pre order visits everything from left first:
-    // first visit root/current node
-    visit(root);
-    // then recursively visit left
-    if (root->left) {
-        preOrderTraversal(root->left, visit);
-    }
-    // then recursively visit right
-    if (root->right) {
-        preOrderTraversal(root->right, visit);
-    }
+void deletePokedexOf(OwnerNode *cur) {
+    outPrintf("Deleting %s's entire Pokedex...\n", cur->ownerName);
+
+    // unlink from the circle (fixes the head if needed), then free name, arena and node
+    applyDeleteOwner(cur);
+    cur = NULL;
+
+    outPrintf("Pokedex deleted.\n");
 }
 
-PokedexQueueNode* createQueueNode(PokemonNode *data) {
-    PokedexQueueNode *newNode = (PokedexQueueNode*)malloc(sizeof(PokedexQueueNode));
-    if (!newNode) {
-        printf("Memory allocation failed.\n");
-        return NULL;
+void evolvePokemon(OwnerNode *owner) {
+    int IDToEvolve = readIntSafe("Enter ID of Pokemon to evolve: ");
+    if (inputExhausted) {
+        return;
     }
-    newNode->data = data;
-    newNode->next = NULL;
-    return newNode;
+    evolvePokemonByID(owner, IDToEvolve);
 }
 
-void displayBFS(PokemonNode *root, VisitNodeFunc visit) {
-    if (root == NULL) {
+void evolvePokemonByID(OwnerNode *owner, int IDToEvolve) {
+    // find ID in BST - if exists, if not, NULL
+    PokemonNode *pokemonToEvolve = findPokemonInOwner(owner, IDToEvolve);
+    // if pokemon not in tree - print message and done
+    if (pokemonToEvolve == NULL) {
+        outPrintf("No Pokemon with ID %d found.\n", IDToEvolve);
         return;
     }
-    if (root->data == NULL) {
+    // if pokemon in tree, but cant evolve - print message and done
+    if (pokemonToEvolve->data->CAN_EVOLVE == CANNOT_EVOLVE) {
+        outPrintf("%s (ID %d) cannot evolve.\n", pokemonToEvolve->data->name, IDToEvolve);
         return;
     }
-    if (root->data->name == NULL) {
+    // otherwise, can evolve, so remove ID from tree, and add ID + 1 to tree
+    applyEvolvePokemon(owner, IDToEvolve);
+    outPrintf("Removing Pokemon %s (ID %d).\n", pokedex[IDToEvolve - 1].name, IDToEvolve);
+    outPrintf("Pokemon evolved from %s (ID %d) to %s (ID %d).\n", pokedex[IDToEvolve - 1].name, IDToEvolve, pokedex[IDToEvolve].name, IDToEvolve + 1);
+}
+
+void pokemonFight(OwnerNode *owner) {
+    int ID1 = readIntSafe("Enter ID of the first Pokemon: ");
+    int ID2 = readIntSafe("Enter ID of the second Pokemon: ");
+    if (inputExhausted) {
         return;
     }
+    fightPokemonByID(owner, ID1, ID2);
+}
 
-    //first create the queue
-    PokedexQueue *queue = malloc(sizeof(PokedexQueue));
-    if (!queue) {
-        printf("Memory allocation failed.\n");
+void fightPokemonByID(OwnerNode *owner, int ID1, int ID2) {
+    PokemonNode *pokemon1 = findPokemonInOwner(owner, ID1);
+    PokemonNode *pokemon2 = findPokemonInOwner(owner, ID2);
+    if (pokemon1 == NULL || pokemon2 == NULL) {
+        outPrintf("One or both Pokemon IDs not found.\n");
         return;
     }
-    // put root into queue
-    PokedexQueueNode *firstNode = createQueueNode(root);
-    queue->front = firstNode;
-    queue->rear = firstNode;
+    float attack1 = speciesScore[pokemon1->data->id - 1];
+    float attack2 = speciesScore[pokemon2->data->id - 1];
+    outPrintf("Pokemon 1: %s (Score = %.2f)\n", pokemon1->data->name, attack1);
+    outPrintf("Pokemon 2: %s (Score = %.2f)\n", pokemon2->data->name, attack2);
 
-    // while queue is not empty, print the front, then enqueue the left and right children
-    while (queue->front) {
-        PokedexQueueNode *current = queue->front;
-        visit(current->data);
-        if (current->data->left) {
-            PokedexQueueNode *tempLeft = createQueueNode(current->data->left);
-            queue->rear->next = tempLeft;
-            queue->rear = tempLeft;
-        }
-        if (current->data->right) {
-            PokedexQueueNode *tempRight = createQueueNode(current->data->right);
-            queue->rear->next = tempRight;
-            queue->rear = tempRight;
-        }
-        queue->front = queue->front->next;
-        free(current);
+    if (attack1 > attack2) {
+        outPrintf("%s wins!\n", pokemon1->data->name);
+        return;
     }
-    free(queue);
+    if (attack2 > attack1) {
+        outPrintf("%s wins!\n", pokemon2->data->name);
+        return;
+    }
+    outPrintf("It's a tie!\n");
 }
 
-PokemonNode *createPokemonNode(const PokemonData *data) {
-    PokemonNode *newPokemon = malloc(sizeof(PokemonNode));
-    if (!newPokemon) {
-        printf("Memory allocation failed.\n");
-        return NULL;
-    }
-    // created the new node, now set all it's values
-    newPokemon->data = malloc(sizeof(PokemonData));
-    if (!newPokemon->data) {
-        printf("Memory allocation failed.\n");
-        return NULL;
+void tallyRoundRobin(const float *scores, int count, int *wins, int *ties) {
+    for (int i = 0; i < count; i++) {
+        float mine = scores[i];
+        int beaten = 0;
+        int equal = 0;
+        // comparisons add up as 0/1, no branches
+        for (int j = 0; j < count; j++) {
+            beaten += (scores[j] < mine);
+            equal += (scores[j] == mine);
+        }
+        wins[i] = beaten;
+        // every score equals itself
+        ties[i] = equal - 1;
     }
-    newPokemon->data->id = data->id;
-    newPokemon->data->name = myStrdup(data->name);
-    newPokemon->data->TYPE = data->TYPE;
-    newPokemon->data->hp = data->hp;
-    newPokemon->data->attack = data->attack;
-    newPokemon->data->CAN_EVOLVE = data->CAN_EVOLVE;
-    newPokemon->left = NULL;
-    newPokemon->right = NULL;
-    return newPokemon;
 }
 
-int addPKMNToBST(PokemonNode *root, int ID) {
-    // edge case: root / data is NULL
-    if (root == NULL) {
-        return -1;
+void pokemonTournament(OwnerNode *owner) {
+    // contestants in ID order, with their scores packed next to each other
+    const PokemonData *contestants[AMOUNT_OF_POKEMON];
+    float scores[AMOUNT_OF_POKEMON];
+    int count = 0;
+    for (int id = 1; id <= AMOUNT_OF_POKEMON; id++) {
+        if (owner->pokemonByID[id] != NULL) {
+            contestants[count] = owner->pokemonByID[id]->data;
+            scores[count] = speciesScore[id - 1];
+            count++;
+        }
     }
-    if (root->data == NULL) {
-        return -1;
+    if (count < 2) {
+        outPrintf("Need at least two Pokemon for a tournament.\n");
+        return;
     }
-    if (!root->data->id) {
-        return -1;
+
+    int wins[AMOUNT_OF_POKEMON];
+    int ties[AMOUNT_OF_POKEMON];
+    tallyRoundRobin(scores, count, wins, ties);
+
+    // standings: bucket by wins (0..count-1), most wins first, ID order inside a bucket
+    int bucketStart[AMOUNT_OF_POKEMON + 1] = {0};
+    int standings[AMOUNT_OF_POKEMON];
+    for (int i = 0; i < count; i++) {
+        bucketStart[count - 1 - wins[i] + 1]++;
     }
-    if (root->data->id <= 0 || root->data->id > AMOUNT_OF_POKEMON) {
-        return -1;
+    for (int b = 1; b <= count; b++) {
+        bucketStart[b] += bucketStart[b - 1];
+    }
+    for (int i = 0; i < count; i++) {
+        standings[bucketStart[count - 1 - wins[i]]++] = i;
     }
 
-    // case 0: ID is already in tree
-    if (ID == root->data->id) {
-        // case: pokemon already in tree -> return 0
-        return 0;
+    outPrintf("\n=== %s's Tournament (%d Pokemon, %d fights) ===\n", owner->ownerName, count,
+              count * (count - 1) / 2);
+    int place = 0;
+    for (int k = 0; k < count; k++) {
+        int i = standings[k];
+        // equal win counts share a place
+        if (k == 0 || wins[i] != wins[standings[k - 1]]) {
+            place = k + 1;
+        }
+        int losses = count - 1 - wins[i] - ties[i];
+        outPrintf("%d. %s (ID %d) - Wins: %d, Ties: %d, Losses: %d (Score = %.2f)\n", place,
+                  contestants[i]->name, contestants[i]->id, wins[i], ties[i], losses, scores[i]);
     }
-    // case 1: ID goes to the right (is greater than current)
-    if (ID > root->data->id) {
-        // if no pokemon to right, add right there
-        // case: successfully put into tree, return 1
-        if (root->right == NULL) {
-            // when getting Pokedex from array, need to minus 1 from ID for index
-            root->right = createPokemonNode(&pokedex[ID - 1]);
-            return 1;
-        }
-        // otherwise, return recursively in next place to the right
-        return addPKMNToBST(root->right, ID);
-    }
-    // otherwise, case 2, it goes to left, and same thing
-    // case: successfully put into tree, return 1
-    if (root->left == NULL) {
-        //when getting Pokedex from array, need to minus 1 from ID for index
-        root->left = createPokemonNode(&pokedex[ID - 1]);
-        return 1;
-    }
-    // otherwise return recursively to the left
-    return addPKMNToBST(root->left, ID);
 }
 
-void addPokemon(OwnerNode *owner) {
-    int IDToAdd = readIntSafe("Enter ID to add: ");
-
-    // edge case(s), root or roots data is empty, in which case, instantialize root to this pokemon
-    if (owner->pokedexRoot == NULL) {
-        owner->pokedexRoot = malloc(sizeof(PokemonNode));
-        if (owner->pokedexRoot == NULL) {
-            printf("Memory allocation failed.\n");
-            return;
-        }
-        owner->pokedexRoot->data = copyPokedexEntryByID(IDToAdd - 1);
-        printf("Pokemon %s (ID %d) added.\n", pokedex[IDToAdd - 1].name, IDToAdd);
+void insertPokemonNode(PokemonNode **root, PokemonNode *newNode) {
+    if (newNode == NULL || newNode->data == NULL) {
+        return;
+    }
+    if (*root == NULL) {
+        *root = newNode;
         return;
     }
-    if (owner->pokedexRoot->data == NULL) {
-        owner->pokedexRoot->data = copyPokedexEntryByID(IDToAdd - 1);
-        printf("Pokemon %s (ID %d) added.\n", pokedex[IDToAdd - 1].name, IDToAdd);
+    if (newNode->data->id < (*root)->data->id) {
+        insertPokemonNode(&((*root)->left), newNode);
+    } else if (newNode->data->id > (*root)->data->id) {
+        insertPokemonNode(&((*root)->right), newNode);
+    } else {
+        // duplicate, tree unchanged
         return;
     }
+    // fix heights (and rotate in balanced mode) on the way back up
+    *root = rebalanceNode(*root);
+}
 
+int getNodeHeight(PokemonNode *node) {
+    if (node == NULL) {
+        return 0;
+    }
+    return node->height;
+}
 
-    // based on ID given, call addPKMNToBST with the root of the BST and the ID wanted
-    int returnStatus = addPKMNToBST(owner->pokedexRoot, IDToAdd);
+void updateNodeHeight(PokemonNode *node) {
+    int leftHeight = getNodeHeight(node->left);
+    int rightHeight = getNodeHeight(node->right);
+    node->height = 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+}
 
-    if (returnStatus == 0) {
-        printf("Pokemon with ID %d is already in the Pokedex. No changes made.\n", IDToAdd);
-        return;
-    }
-    printf("Pokemon %s (ID %d) added.\n", pokedex[IDToAdd - 1].name, IDToAdd);
+PokemonNode *rotateLeft(PokemonNode *root) {
+    PokemonNode *newRoot = root->right;
+    root->right = newRoot->left;
+    newRoot->left = root;
+    // old root is now below the new root, so update it first
+    updateNodeHeight(root);
+    updateNodeHeight(newRoot);
+    return newRoot;
+}
 
+PokemonNode *rotateRight(PokemonNode *root) {
+    PokemonNode *newRoot = root->left;
+    root->left = newRoot->right;
+    newRoot->right = root;
+    updateNodeHeight(root);
+    updateNodeHeight(newRoot);
+    return newRoot;
 }
 
-void printAllOwners() {
-    OwnerNode *temp = ownerHead;
-    int upTo = 1;
-    do {
-        printf("%d. %s\n", upTo, temp->ownerName);
-        upTo++;
-        temp = temp->next;
-    } while (temp != ownerHead);
+PokemonNode *rebalanceNode(PokemonNode *root) {
+    if (root == NULL) {
+        return NULL;
+    }
+    updateNodeHeight(root);
+    if (!BALANCED_POKEDEX) {
+        return root;
+    }
+    int balance = getNodeHeight(root->left) - getNodeHeight(root->right);
+    // left heavy: single right rotation, or left-right if the heavy side leans inward
+    if (balance > 1) {
+        if (getNodeHeight(root->left->left) < getNodeHeight(root->left->right)) {
+            root->left = rotateLeft(root->left);
+        }
+        return rotateRight(root);
+    }
+    // right heavy: mirror image
+    if (balance < -1) {
+        if (getNodeHeight(root->right->right) < getNodeHeight(root->right->left)) {
+            root->right = rotateRight(root->right);
+        }
+        return rotateLeft(root);
+    }
+    return root;
 }
 
-PokemonData *copyPokedexEntryByID(int id) {
-    PokemonData *newData = malloc(sizeof(PokemonData));
-    if (!newData) {
-        printf("Memory allocation failed.\n");
+PokemonNode *unlinkPokemonNode(PokemonNode **root, int id) {
+    // links (parent pointer slots) of every node whose height may change, top to bottom.
+    // a tree holds at most AMOUNT_OF_POKEMON nodes, so that bounds the path length too
+    PokemonNode **path[AMOUNT_OF_POKEMON];
+    int depth = 0;
+
+    // walk down to the node, remembering the path
+    PokemonNode **link = root;
+    while (*link != NULL && (*link)->data->id != id) {
+        path[depth++] = link;
+        link = (id > (*link)->data->id) ? &((*link)->right) : &((*link)->left);
+    }
+    PokemonNode *target = *link;
+    if (target == NULL) {
         return NULL;
     }
 
-    newData->id = pokedex[id].id;
-    newData->name = myStrdup(pokedex[id].name);
-    newData->attack = pokedex[id].attack;
-    newData->hp = pokedex[id].hp;
-    newData->TYPE = pokedex[id].TYPE;
-    newData->CAN_EVOLVE = pokedex[id].CAN_EVOLVE;
+    if (target->left == NULL) {
+        // case: 0 or 1 children - the child (or NULL) takes the node's place
+        *link = target->right;
+    } else if (target->right == NULL) {
+        *link = target->left;
+    } else {
+        // case: 2 children - splice the in-order successor (leftmost on the right) into the node's place
+        path[depth++] = link;
+        int firstBelowTarget = depth;
+        PokemonNode **successorLink = &(target->right);
+        while ((*successorLink)->left != NULL) {
+            path[depth++] = successorLink;
+            successorLink = &((*successorLink)->left);
+        }
+        PokemonNode *successor = *successorLink;
+        // detach the successor first, then let it adopt the target's children
+        *successorLink = successor->right;
+        successor->left = target->left;
+        successor->right = target->right;
+        *link = successor;
+        // that slot lived inside the target, it now lives inside the successor
+        if (depth > firstBelowTarget && path[firstBelowTarget] == &(target->right)) {
+            path[firstBelowTarget] = &(successor->right);
+        }
+    }
 
-    return newData;
+    // fix heights (and rotate in balanced mode) from the bottom of the path up
+    for (int i = depth - 1; i >= 0; i--) {
+        *path[i] = rebalanceNode(*path[i]);
+    }
+    target->left = NULL;
+    target->right = NULL;
+    return target;
 }
 
-void openPokedexMenu() {
-    // create the new node
-    OwnerNode* newOwner = malloc(sizeof(OwnerNode));
-    if (newOwner == NULL) {
-        printf("Memory allocation failed.\n");
-        return;
+void collectInOrder(PokemonNode *root, PokemonNode **nodes, int *count) {
+    // explicit stack like inOrderTraversal: the tree is only read, never rewired
+    PokemonNode *stack[AMOUNT_OF_POKEMON];
+    int top = 0;
+    PokemonNode *current = root;
+    while (current != NULL || top > 0) {
+        while (current != NULL) {
+            stack[top++] = current;
+            current = current->left;
+        }
+        current = stack[--top];
+        nodes[(*count)++] = current;
+        current = current->right;
     }
+}
 
-    // get the new node's data
-    printf("Your name: ");
-    newOwner->ownerName = getDynamicInput();
-    if (findOwnerByName(newOwner->ownerName) != NULL) {
-        printf("Owner '%s' already exists. Not creating a new Pokedex.\n", newOwner->ownerName);
-        free(newOwner->ownerName);
-        free(newOwner);
-        newOwner = NULL;
-        return;
+PokemonNode *buildBalancedTree(PokemonNode **nodes, int count) {
+    if (count <= 0) {
+        return NULL;
     }
-    printf("Choose Starter:\n1. Bulbasaur\n2. Charmander\n3. Squirtle\n");
-    int choice = readIntSafe("Your choice: ");
-    if (choice < BULBASAUR_OPT || choice > SQUIRTLE_OPT) {
-        printf("Invalid choice.\n");
+    // middle node becomes the root, each half becomes a subtree
+    int middle = count / 2;
+    PokemonNode *root = nodes[middle];
+    root->left = buildBalancedTree(nodes, middle);
+    root->right = buildBalancedTree(nodes + middle + 1, count - middle - 1);
+    updateNodeHeight(root);
+    return root;
+}
+
+int mergeSortedPokemonNodes(PokemonNode **first, int firstCount, PokemonNode **second, int secondCount,
+                            PokemonNode **merged) {
+    int i = 0;
+    int j = 0;
+    int mergedCount = 0;
+    // classic two-pointer union of two ascending sequences
+    while (i < firstCount && j < secondCount) {
+        int firstID = first[i]->data->id;
+        int secondID = second[j]->data->id;
+        if (firstID < secondID) {
+            merged[mergedCount++] = first[i++];
+        } else if (secondID < firstID) {
+            merged[mergedCount++] = second[j++];
+        } else {
+            // same Pokemon in both: keep the first one, skip the extra copy
+            merged[mergedCount++] = first[i++];
+            j++;
+        }
+    }
+    while (i < firstCount) {
+        merged[mergedCount++] = first[i++];
+    }
+    while (j < secondCount) {
+        merged[mergedCount++] = second[j++];
+    }
+    return mergedCount;
+}
+
+void freePokemon(OwnerNode *owner) {
+    int choiceOfIDToFree = readIntSafe("Enter Pokemon ID to release: ");
+    if (inputExhausted) {
         return;
     }
-    newOwner->pokedexRoot = malloc(sizeof(PokemonNode));
-    if (newOwner->pokedexRoot == NULL) {
-        printf("Memory allocation failed.\n");
+    releasePokemonByID(owner, choiceOfIDToFree);
+}
+
+void releasePokemonByID(OwnerNode *owner, int choiceOfIDToFree) {
+    // the index answers "is it here?" without touching the tree
+    if (findPokemonInOwner(owner, choiceOfIDToFree) == NULL) {
+        outPrintf("No Pokemon with ID %d found.\n", choiceOfIDToFree);
         return;
     }
-    int idOfChoice;
-    if (choice == BULBASAUR_OPT) {idOfChoice = BULBASAUR_ID;}
-    else if (choice == CHARMANDER_OPT) {idOfChoice = CHARMANDER_ID;}
-    else {idOfChoice = SQUIRTLE_ID;}
-    newOwner->pokedexRoot->data = copyPokedexEntryByID(idOfChoice - 1);
-    printf("New Pokedex created for %s with starter %s.\n", newOwner->ownerName, newOwner->pokedexRoot->data->name);
+    applyReleasePokemon(owner, choiceOfIDToFree);
+}
 
-    // assign this new node a location in the node circle
-    // if it's the first, set its location to itself
-    if (ownerHead == NULL) {
-        ownerHead = newOwner;
-        ownerHead->next = ownerHead;
-        ownerHead->prev = ownerHead;
-    } else {
-    // otherwise slip it in before the head / in last place in the circle
-        OwnerNode *lastNode = ownerHead->prev;
-        lastNode->next = newOwner;
-        newOwner->prev = lastNode;
-        newOwner->next = ownerHead;
-        ownerHead->prev = newOwner;
+void mergeOwnerPokedexes(OwnerNode *target, OwnerNode *source) {
+    // IDs are unique per tree, so AMOUNT_OF_POKEMON slots always fit a whole tree
+    PokemonNode *targetNodes[AMOUNT_OF_POKEMON];
+    PokemonNode *sourceNodes[AMOUNT_OF_POKEMON];
+    PokemonNode *mergedNodes[AMOUNT_OF_POKEMON];
+    int targetCount = 0;
+    int sourceCount = 0;
+    collectInOrder(target->pokedexRoot, targetNodes, &targetCount);
+    collectInOrder(source->pokedexRoot, sourceNodes, &sourceCount);
+
+    // one linear union, duplicates keep the target's node
+    int mergedCount = mergeSortedPokemonNodes(targetNodes, targetCount, sourceNodes, sourceCount, mergedNodes);
+
+    // nodes that came from the source get a home in the target's arena
+    int keptCount = 0;
+    for (int i = 0; i < mergedCount; i++) {
+        PokemonNode *node = mergedNodes[i];
+        if (target->pokemonByID[node->data->id] != node) {
+            node = allocArenaNode(&target->arena, node->data);
+            if (node == NULL) {
+                continue;
+            }
+            target->pokemonByID[node->data->id] = node;
+            markSpeciesHeld(target, node->data->id);
+        }
+        mergedNodes[keptCount++] = node;
     }
+    target->pokedexRoot = buildBalancedTree(mergedNodes, keptCount);
 
+    // the source's tree is now fully copied, drop it in one go
+    releaseArena(&source->arena);
+    source->pokedexRoot = NULL;
+    memset(source->pokemonByID, 0, sizeof(source->pokemonByID));
+    clearOwnerMasks(source);
 }
 
-void recursivelyCleanNullPokemon(PokemonNode **root) {
-    if (root == NULL || *root == NULL) {
-        return;
+int addSpeciesMaskToOwner(OwnerNode *owner, const SpeciesMask *mask) {
+    PokemonNode *heldNodes[AMOUNT_OF_POKEMON];
+    PokemonNode *newNodes[AMOUNT_OF_POKEMON];
+    PokemonNode *mergedNodes[AMOUNT_OF_POKEMON];
+    int heldCount = 0;
+    int newCount = 0;
+    collectInOrder(owner->pokedexRoot, heldNodes, &heldCount);
+
+    // species not held yet, in ID order: already sorted for the merge
+    for (int id = 1; id <= AMOUNT_OF_POKEMON; id++) {
+        if (!hasSpeciesBit(mask, id) || owner->pokemonByID[id] != NULL) {
+            continue;
+        }
+        PokemonNode *node = allocArenaNode(&owner->arena, &pokedex[id - 1]);
+        if (node == NULL) {
+            break;
+        }
+        owner->pokemonByID[id] = node;
+        markSpeciesHeld(owner, id);
+        newNodes[newCount++] = node;
     }
-    if ((*root)->data == NULL || (*root)->data->name == NULL) {
-        *root = NULL;
-        return;
+    if (newCount == 0) {
+        return 0;
     }
-    recursivelyCleanNullPokemon(&((*root)->left));
-    recursivelyCleanNullPokemon(&((*root)->right));
+
+    // one linear union, then a balanced tree straight from the sorted sequence
+    int mergedCount = mergeSortedPokemonNodes(heldNodes, heldCount, newNodes, newCount, mergedNodes);
+    owner->pokedexRoot = buildBalancedTree(mergedNodes, mergedCount);
+    return newCount;
 }
 
-void trimWhitespace(char *str)
-{
-    // Remove leading spaces/tabs/\r
-    int start = 0;
-    while (str[start] == ' ' || str[start] == '\t' || str[start] == '\r')
-        start++;
+// One thread's share of unionHeldMasks
+typedef struct MaskReduction {
+    OwnerNode *const *owners;
+    int count;
+    SpeciesMask result;
+} MaskReduction;
 
-    if (start > 0)
-    {
-        int idx = 0;
-        while (str[start])
-            str[idx++] = str[start++];
-        str[idx] = '\0';
+static void *reduceHeldMasks(void *arg) {
+    MaskReduction *part = (MaskReduction *)arg;
+    memset(&part->result, 0, sizeof(part->result));
+    for (int i = 0; i < part->count; i++) {
+        for (int w = 0; w < SPECIES_MASK_WORDS; w++) {
+            part->result.words[w] |= part->owners[i]->heldMask.words[w];
+        }
+    }
+    return NULL;
+}
+
+void unionHeldMasks(OwnerNode *const *owners, int count, SpeciesMask *result) {
+    MaskReduction parts[BULK_MERGE_THREADS];
+    pthread_t threads[BULK_MERGE_THREADS];
+    int started[BULK_MERGE_THREADS] = {0};
+    int partCount = count / BULK_MERGE_OWNERS_PER_THREAD;
+    if (partCount > BULK_MERGE_THREADS) {
+        partCount = BULK_MERGE_THREADS;
+    }
+    if (partCount < 1) {
+        partCount = 1;
     }
 
-    // Remove trailing spaces/tabs/\r
-    int len = (int)strlen(str);
-    while (len > 0 && (str[len - 1] == ' ' || str[len - 1] == '\t' || str[len - 1] == '\r'))
-    {
-        str[--len] = '\0';
+    // contiguous slices; part 0 runs on this thread, and any thread that can't start runs here too
+    int first = 0;
+    for (int p = 0; p < partCount; p++) {
+        int size = count / partCount + (p < count % partCount);
+        parts[p].owners = owners + first;
+        parts[p].count = size;
+        first += size;
+        if (p > 0) {
+            started[p] = (pthread_create(&threads[p], NULL, reduceHeldMasks, &parts[p]) == 0);
+        }
+    }
+    reduceHeldMasks(&parts[0]);
+    for (int p = 1; p < partCount; p++) {
+        if (started[p]) {
+            pthread_join(threads[p], NULL);
+        } else {
+            reduceHeldMasks(&parts[p]);
+        }
+    }
+
+    // combine the partial masks pairwise, halving their number each round
+    for (int step = 1; step < partCount; step *= 2) {
+        for (int p = 0; p + step < partCount; p += 2 * step) {
+            for (int w = 0; w < SPECIES_MASK_WORDS; w++) {
+                parts[p].result.words[w] |= parts[p + step].result.words[w];
+            }
+        }
     }
+    *result = parts[0].result;
 }
 
-char *myStrdup(const char *src)
-{
-    if (!src)
-        return NULL;
-    size_t len = strlen(src);
-    char *dest = (char *)malloc(len + 1);
-    if (!dest)
-    {
-        printf("Memory allocation failed in myStrdup.\n");
+PokemonNode *findPokemonInOwner(OwnerNode *owner, int id) {
+    if (id <= 0 || id > AMOUNT_OF_POKEMON) {
         return NULL;
     }
-    strcpy(dest, src);
-    return dest;
+    return owner->pokemonByID[id];
 }
 
-int readIntSafe(const char *prompt)
-{
-    char buffer[INT_BUFFER];
-    int value;
-    int success = 0;
+int addPokemonToOwner(OwnerNode *owner, int id) {
+    if (id <= 0 || id > AMOUNT_OF_POKEMON) {
+        return -1;
+    }
+    // duplicate check is a single array load
+    if (owner->pokemonByID[id] != NULL) {
+        return 0;
+    }
+    // when getting Pokedex from array, need to minus 1 from ID for index
+    PokemonNode *newNode = allocArenaNode(&owner->arena, &pokedex[id - 1]);
+    if (newNode == NULL) {
+        return -1;
+    }
+    // rotations move nodes around but never replace them, so the pointer stays valid
+    insertPokemonNode(&(owner->pokedexRoot), newNode);
+    owner->pokemonByID[id] = newNode;
+    markSpeciesHeld(owner, id);
+    return 1;
+}
 
-    while (!success)
-    {
-        printf("%s", prompt);
+void releasePokemonFromOwner(OwnerNode *owner, int id) {
+    // removal relinks nodes instead of moving data between them, so only this entry goes stale
+    PokemonNode *released = unlinkPokemonNode(&(owner->pokedexRoot), id);
+    if (released == NULL) {
+        outPrintf("No Pokemon with ID %d found.\n", id);
+        return;
+    }
+    outPrintf("Removing Pokemon %s (ID %d).\n", released->data->name, id);
+    owner->pokemonByID[id] = NULL;
+    markSpeciesReleased(owner, id);
+    freeArenaNode(&owner->arena, released);
+}
 
-        // If we fail to read, treat it as invalid
-        if (!fgets(buffer, sizeof(buffer), stdin))
-        {
-            printf("Invalid input.\n");
-            clearerr(stdin);
-            continue;
+void displayAlphabetical(PokemonNode *root, VisitNodeFunc visit) {
+    // every species has its own rank, so the slots are the alphabetical order already
+    PokemonNode *byRank[AMOUNT_OF_POKEMON] = {NULL};
+    PokemonNode *stack[AMOUNT_OF_POKEMON];
+    int top = 0;
+    if (root != NULL) {
+        stack[top++] = root;
+    }
+    while (top > 0) {
+        PokemonNode *node = stack[--top];
+        byRank[speciesNameRank[node->data->id - 1]] = node;
+        if (node->right) {
+            stack[top++] = node->right;
+        }
+        if (node->left) {
+            stack[top++] = node->left;
         }
+    }
 
-        // 1) Strip any trailing \r or \n
-        //    so "123\r\n" becomes "123"
-        size_t len = strlen(buffer);
-        if (len > 0 && (buffer[len - 1] == '\n' || buffer[len - 1] == '\r'))
-            buffer[--len] = '\0';
-        if (len > 0 && (buffer[len - 1] == '\r' || buffer[len - 1] == '\n'))
-            buffer[--len] = '\0';
+    for (int rank = 0; rank < AMOUNT_OF_POKEMON; rank++) {
+        if (byRank[rank] != NULL) {
+            visit(byRank[rank]);
+        }
+    }
+}
 
-        // 2) Check if empty after stripping
-        if (len == 0)
-        {
-            printf("Invalid input.\n");
+int compareSpeciesByName(const void *a, const void *b) {
+    // run strcmp on the two catalog names for qsort compare
+    return strcmp(pokedex[*(const int *)a].name, pokedex[*(const int *)b].name);
+}
+
+void postOrderTraversal(PokemonNode *root, VisitNodeFunc visit) {
+    // post order visits bottom node from left path first, then right, then back to root
+    // explicit stack of the path from the root; a node is visited once its right side is done
+    PokemonNode *stack[AMOUNT_OF_POKEMON];
+    int top = 0;
+    PokemonNode *current = root;
+    PokemonNode *lastVisited = NULL;
+    while (current != NULL || top > 0) {
+        // go down the left path
+        if (current != NULL) {
+            stack[top++] = current;
+            current = current->left;
             continue;
         }
+        PokemonNode *peek = stack[top - 1];
+        // right subtree still to do
+        if (peek->right != NULL && peek->right != lastVisited) {
+            current = peek->right;
+            continue;
+        }
+        // both sides done: visit root
+        visit(peek);
+        lastVisited = peek;
+        top--;
+    }
+}
 
-        // 3) Attempt to parse integer with strtol
-        char *endptr;
-        value = (int)strtol(buffer, &endptr, 10);
+void inOrderTraversal(PokemonNode *root, VisitNodeFunc visit) {
+    // in order visits bottom node from left path first, then back to root, then right, then back
+    // explicit stack of the nodes whose left side is in progress; the tree itself is only read,
+    // so any number of displays can walk one Pokedex at the same time
+    PokemonNode *stack[AMOUNT_OF_POKEMON];
+    int top = 0;
+    PokemonNode *current = root;
+    while (current != NULL || top > 0) {
+        // go down the left path
+        while (current != NULL) {
+            stack[top++] = current;
+            current = current->left;
+        }
+        // left side done: visit root, then do the right side
+        current = stack[--top];
+        visit(current);
+        current = current->right;
+    }
+}
 
-        // If endptr didn't point to the end => leftover chars => invalid
-        // or if buffer was something non-numeric
-        if (*endptr != '\0')
-        {
-            printf("Invalid input.\n");
+void preOrderTraversal(PokemonNode *root, VisitNodeFunc visit) {
+    // pre order visits everything from left first:
+    // visit on the way down, keep the right children still to do on a stack
+    PokemonNode *stack[AMOUNT_OF_POKEMON];
+    int top = 0;
+    PokemonNode *current = root;
+    while (current != NULL || top > 0) {
+        if (current == NULL) {
+            current = stack[--top];
         }
-        else
-        {
-            // We got a valid integer
-            success = 1;
+        visit(current);
+        if (current->right != NULL) {
+            stack[top++] = current->right;
         }
+        current = current->left;
     }
-    return value;
 }
 
-// --------------------------------------------------------------
-// 2) Utility: Get type name from enum
-// --------------------------------------------------------------
-const char *getTypeName(PokemonType type)
-{
-    switch (type)
-    {
-    case GRASS:
-        return "GRASS";
-    case FIRE:
-        return "FIRE";
-    case WATER:
-        return "WATER";
-    case BUG:
-        return "BUG";
-    case NORMAL:
-        return "NORMAL";
-    case POISON:
-        return "POISON";
-    case ELECTRIC:
-        return "ELECTRIC";
-    case GROUND:
-        return "GROUND";
-    case FAIRY:
-        return "FAIRY";
-    case FIGHTING:
-        return "FIGHTING";
-    case PSYCHIC:
-        return "PSYCHIC";
-    case ROCK:
-        return "ROCK";
-    case GHOST:
-        return "GHOST";
-    case DRAGON:
-        return "DRAGON";
-    case ICE:
-        return "ICE";
-    default:
-        return "UNKNOWN";
+void displayByStats(OwnerNode *owner) {
+    int minHP = readIntSafe("Minimum HP: ");
+    int maxHP = readIntSafe("Maximum HP (0 for no limit): ");
+    int minAttack = readIntSafe("Minimum Attack: ");
+    int maxAttack = readIntSafe("Maximum Attack (0 for no limit): ");
+    if (!batchMode && !inputExhausted) {
+        for (int type = 0; type < POKEMON_TYPE_COUNT; type++) {
+            outPrintf("%d. %s\n", type + 1, getTypeName((PokemonType)type));
+        }
+    }
+    int typeChoice = readIntSafe("Type (0 for any): ");
+    int evolveChoice = readIntSafe("Can evolve (0 for either, 1 yes, 2 no): ");
+    if (inputExhausted) {
+        return;
+    }
+    StatFilter filter;
+    if (!setStatFilter(&filter, minHP, maxHP, minAttack, maxAttack, typeChoice, evolveChoice)) {
+        outPrintf("Invalid choice.\n");
+        return;
     }
+    displayStatMatches(owner, &filter);
 }
 
-// --------------------------------------------------------------
-// Utility: getDynamicInput (for reading a line into malloc'd memory)
-// --------------------------------------------------------------
-char *getDynamicInput()
-{
-    char *input = NULL;
-    size_t size = 0, capacity = 1;
-    input = (char *)malloc(capacity);
-    if (!input)
-    {
-        printf("Memory allocation failed.\n");
-        return NULL;
+void displayStatMatches(OwnerNode *owner, const StatFilter *filter) {
+    // whole catalog first, then keep only what this owner has
+    SpeciesMask matches;
+    filterSpecies(filter, &matches);
+    intersectSpeciesMasks(&matches, &owner->heldMask, &matches);
+    if (countSpeciesMask(&matches) == 0) {
+        outPrintf("No Pokemon match.\n");
+        return;
+    }
+    visitSpeciesMask(owner, &matches, printPokemonNode);
+}
+
+void displayByType(OwnerNode *owner) {
+    if (!batchMode) {
+        for (int type = 0; type < POKEMON_TYPE_COUNT; type++) {
+            outPrintf("%d. %s\n", type + 1, getTypeName((PokemonType)type));
+        }
+    }
+    int choice = readIntSafe("Choose a type: ");
+    if (inputExhausted) {
+        return;
+    }
+    displayTypeMatches(owner, choice);
+}
+
+void displayTypeMatches(OwnerNode *owner, int choice) {
+    if (choice < 1 || choice > POKEMON_TYPE_COUNT) {
+        outPrintf("Invalid choice.\n");
+        return;
+    }
+    const SpeciesMask *ofType = &owner->typeMasks[choice - 1];
+    if (countSpeciesMask(ofType) == 0) {
+        outPrintf("No %s Pokemon.\n", getTypeName((PokemonType)(choice - 1)));
+        return;
+    }
+    visitSpeciesMask(owner, ofType, printPokemonNode);
+}
+
+void visitSpeciesMask(OwnerNode *owner, const SpeciesMask *mask, VisitNodeFunc visit) {
+    for (int w = 0; w < SPECIES_MASK_WORDS; w++) {
+        uint64_t word = mask->words[w];
+        // peel off the lowest set bit each round
+        while (word != 0) {
+            int bit = 0;
+            while (((word >> bit) & 1u) == 0) {
+                bit++;
+            }
+            word &= word - 1;
+            visit(owner->pokemonByID[w * 64 + bit + 1]);
+        }
+    }
+}
+
+void setSpeciesBit(SpeciesMask *mask, int id) {
+    mask->words[(id - 1) / 64] |= (uint64_t)1 << ((id - 1) % 64);
+}
+
+void clearSpeciesBit(SpeciesMask *mask, int id) {
+    mask->words[(id - 1) / 64] &= ~((uint64_t)1 << ((id - 1) % 64));
+}
+
+int hasSpeciesBit(const SpeciesMask *mask, int id) {
+    return (int)((mask->words[(id - 1) / 64] >> ((id - 1) % 64)) & 1u);
+}
+
+void markSpeciesHeld(OwnerNode *owner, int id) {
+    setSpeciesBit(&owner->heldMask, id);
+    setSpeciesBit(&owner->typeMasks[pokedexColumns.type[id - 1]], id);
+    addSpeciesHolder(owner, id);
+}
+
+void markSpeciesReleased(OwnerNode *owner, int id) {
+    clearSpeciesBit(&owner->heldMask, id);
+    clearSpeciesBit(&owner->typeMasks[pokedexColumns.type[id - 1]], id);
+    removeSpeciesHolder(owner, id);
+}
+
+void clearOwnerMasks(OwnerNode *owner) {
+    // every held species drops this owner from its holder list
+    for (int w = 0; w < SPECIES_MASK_WORDS; w++) {
+        uint64_t word = owner->heldMask.words[w];
+        while (word != 0) {
+            int bit = 0;
+            while (((word >> bit) & 1u) == 0) {
+                bit++;
+            }
+            word &= word - 1;
+            removeSpeciesHolder(owner, w * 64 + bit + 1);
+        }
+    }
+    memset(&owner->heldMask, 0, sizeof(owner->heldMask));
+    memset(owner->typeMasks, 0, sizeof(owner->typeMasks));
+}
+
+void intersectSpeciesMasks(const SpeciesMask *a, const SpeciesMask *b, SpeciesMask *result) {
+    for (int w = 0; w < SPECIES_MASK_WORDS; w++) {
+        result->words[w] = a->words[w] & b->words[w];
+    }
+}
+
+int countSpeciesMask(const SpeciesMask *mask) {
+    int count = 0;
+    for (int w = 0; w < SPECIES_MASK_WORDS; w++) {
+        uint64_t word = mask->words[w];
+        while (word != 0) {
+            word &= word - 1;
+            count++;
+        }
+    }
+    return count;
+}
+
+void initStatFilter(StatFilter *filter) {
+    filter->minHP = 0;
+    filter->maxHP = INT_MAX;
+    filter->minAttack = 0;
+    filter->maxAttack = INT_MAX;
+    filter->type = FILTER_ANY;
+    filter->canEvolve = FILTER_ANY;
+}
+
+int setStatFilter(StatFilter *filter, int minHP, int maxHP, int minAttack, int maxAttack,
+                  int typeChoice, int evolveChoice) {
+    if (typeChoice < 0 || typeChoice > POKEMON_TYPE_COUNT || evolveChoice < 0 || evolveChoice > 2) {
+        return 0;
+    }
+    initStatFilter(filter);
+    filter->minHP = minHP;
+    filter->minAttack = minAttack;
+    // 0 (or less) for a maximum means no upper bound
+    if (maxHP > 0) {
+        filter->maxHP = maxHP;
+    }
+    if (maxAttack > 0) {
+        filter->maxAttack = maxAttack;
+    }
+    // menu numbers start at 1, the enums at 0
+    if (typeChoice > 0) {
+        filter->type = typeChoice - 1;
+    }
+    if (evolveChoice > 0) {
+        filter->canEvolve = (evolveChoice == 1) ? CAN_EVOLVE : CANNOT_EVOLVE;
+    }
+    return 1;
+}
+
+void filterSpecies(const StatFilter *filter, SpeciesMask *result) {
+    // pass 1: one 0/1 byte per species; only &, | and compares, so the loop vectorizes
+    unsigned char match[AMOUNT_OF_POKEMON];
+    const PokedexColumns *columns = &pokedexColumns;
+    int anyType = (filter->type == FILTER_ANY);
+    int anyEvolve = (filter->canEvolve == FILTER_ANY);
+    for (int i = 0; i < AMOUNT_OF_POKEMON; i++) {
+        match[i] = (unsigned char)((columns->hp[i] >= filter->minHP) & (columns->hp[i] <= filter->maxHP) &
+                                   (columns->attack[i] >= filter->minAttack) &
+                                   (columns->attack[i] <= filter->maxAttack) &
+                                   ((columns->type[i] == filter->type) | anyType) &
+                                   ((columns->canEvolve[i] == filter->canEvolve) | anyEvolve));
+    }
+    // pass 2: pack the bytes into mask words
+    for (int w = 0; w < SPECIES_MASK_WORDS; w++) {
+        uint64_t word = 0;
+        for (int bit = 0; bit < 64 && w * 64 + bit < AMOUNT_OF_POKEMON; bit++) {
+            word |= (uint64_t)match[w * 64 + bit] << bit;
+        }
+        result->words[w] = word;
+    }
+}
+
+int parseSpeciesList(const char *text, SpeciesMask *result) {
+    memset(result, 0, sizeof(*result));
+    const char *cursor = text;
+    while (1) {
+        while (*cursor == ',' || isspace((unsigned char)*cursor)) {
+            cursor++;
+        }
+        if (*cursor == '\0') {
+            break;
+        }
+        // an item is an ID or a "first-last" range, both ends in the catalog
+        char *end;
+        long first = strtol(cursor, &end, 10);
+        long last = first;
+        if (end == cursor) {
+            return -1;
+        }
+        if (*end == '-') {
+            cursor = end + 1;
+            last = strtol(cursor, &end, 10);
+            if (end == cursor) {
+                return -1;
+            }
+        }
+        if (first < 1 || last > AMOUNT_OF_POKEMON || first > last ||
+            (*end != '\0' && *end != ',' && !isspace((unsigned char)*end))) {
+            return -1;
+        }
+        for (long id = first; id <= last; id++) {
+            setSpeciesBit(result, (int)id);
+        }
+        cursor = end;
+    }
+    return countSpeciesMask(result);
+}
+
+void initPokemonQueue(PokemonQueue *queue) {
+    queue->front = 0;
+    queue->count = 0;
+}
+
+int pushPokemonQueue(PokemonQueue *queue, PokemonNode *node) {
+    if (queue->count == AMOUNT_OF_POKEMON) {
+        return 0;
+    }
+    // the back is count slots after the front, wrapping around the array
+    int back = (queue->front + queue->count) % AMOUNT_OF_POKEMON;
+    queue->items[back] = node;
+    queue->count++;
+    return 1;
+}
+
+PokemonNode *popPokemonQueue(PokemonQueue *queue) {
+    if (queue->count == 0) {
+        return NULL;
+    }
+    PokemonNode *node = queue->items[queue->front];
+    queue->front = (queue->front + 1) % AMOUNT_OF_POKEMON;
+    queue->count--;
+    return node;
+}
+
+void displayBFS(PokemonNode *root, VisitNodeFunc visit) {
+    if (root == NULL) {
+        return;
+    }
+    if (root->data == NULL) {
+        return;
+    }
+    if (root->data->name == NULL) {
+        return;
+    }
+
+    // the queue lives on the stack: a Pokedex has at most AMOUNT_OF_POKEMON nodes
+    PokemonQueue queue;
+    initPokemonQueue(&queue);
+    pushPokemonQueue(&queue, root);
+
+    // while queue is not empty, print the front, then enqueue the left and right children
+    PokemonNode *current;
+    while ((current = popPokemonQueue(&queue)) != NULL) {
+        visit(current);
+        if (current->left) {
+            pushPokemonQueue(&queue, current->left);
+        }
+        if (current->right) {
+            pushPokemonQueue(&queue, current->right);
+        }
+    }
+}
+
+void addPokemon(OwnerNode *owner) {
+    int IDToAdd = readIntSafe("Enter ID to add: ");
+    if (inputExhausted) {
+        return;
+    }
+    addPokemonByID(owner, IDToAdd);
+}
+
+void addPokemonByID(OwnerNode *owner, int IDToAdd) {
+
+    // based on ID given, add it to the owner's BST and ID index
+    // (an empty pokedex is just a NULL root, the first node becomes the root)
+    int returnStatus = applyAddPokemon(owner, IDToAdd);
+
+    if (returnStatus == -1) {
+        outPrintf("Invalid ID.\n");
+        return;
+    }
+    if (returnStatus == 0) {
+        outPrintf("Pokemon with ID %d is already in the Pokedex. No changes made.\n", IDToAdd);
+        return;
+    }
+    outPrintf("Pokemon %s (ID %d) added.\n", pokedex[IDToAdd - 1].name, IDToAdd);
+
+}
+
+void bulkAddPokemon(OwnerNode *owner) {
+    printPrompt("Enter IDs to add (e.g. 1-10,25): ");
+    char *idList = getDynamicInput();
+    if (!idList) {
+        outPrintf("Memory allocation failed.\n");
+        return;
+    }
+    if (!inputExhausted) {
+        bulkAddPokemonByIDs(owner, idList);
+    }
+    free(idList);
+}
+
+void bulkAddPokemonByIDs(OwnerNode *owner, const char *idList) {
+    SpeciesMask requested;
+    int requestedCount = parseSpeciesList(idList, &requested);
+    if (requestedCount < 0) {
+        outPrintf("Invalid ID list.\n");
+        return;
+    }
+    // IDs already in the Pokedex are skipped inside; the rest go in with one rebuild
+    int added = applyBulkAdd(owner, &requested);
+    outPrintf("Added %d, skipped %d.\n", added, requestedCount - added);
+}
+
+void printAllOwners() {
+    printOwnersPage(0, ownerDirectory.count);
+}
+
+void printOwnersPage(int first, int amount) {
+    for (int i = first; i < first + amount && i < ownerDirectory.count; i++) {
+        outInt(i + 1);
+        outWrite(". ", 2);
+        outString(ownerDirectory.owners[i]->ownerName);
+        outWrite("\n", 1);
+    }
+}
+
+int readOwnerChoice(const char *prompt) {
+    // batch mode has no one to show the list to
+    if (batchMode) {
+        return readIntSafe(prompt);
+    }
+    // small lists look exactly like before: everything, then the prompt
+    if (ownerDirectory.count <= OWNERS_PAGE_SIZE) {
+        printAllOwners();
+        return readIntSafe(prompt);
+    }
+    int pageCount = (ownerDirectory.count + OWNERS_PAGE_SIZE - 1) / OWNERS_PAGE_SIZE;
+    int page = 0;
+    while (1) {
+        printOwnersPage(page * OWNERS_PAGE_SIZE, OWNERS_PAGE_SIZE);
+        outPrintf("Page %d of %d (enter 0 for the next page).\n", page + 1, pageCount);
+        int choice = readIntSafe(prompt);
+        if (choice != 0 || inputExhausted) {
+            return choice;
+        }
+        page = (page + 1) % pageCount;
+    }
+}
+
+OwnerNode *createOwner(char *ownerName, int starterID) {
+    // calloc so the ID index and the arena start out empty
+    OwnerNode *newOwner = calloc(1, sizeof(OwnerNode));
+    if (newOwner == NULL) {
+        outPrintf("Memory allocation failed.\n");
+        return NULL;
+    }
+    newOwner->ownerName = ownerName;
+    newOwner->pokedexRoot = NULL;
+    newOwner->next = NULL;
+    newOwner->prev = NULL;
+    pthread_rwlock_init(&newOwner->lock, NULL);
+    if (starterID != 0 && addPokemonToOwner(newOwner, starterID) != 1) {
+        pthread_rwlock_destroy(&newOwner->lock);
+        free(newOwner);
+        return NULL;
+    }
+    return newOwner;
+}
+
+PokemonNode *allocArenaNode(PokedexArena *arena, const PokemonData *data) {
+    PokemonNode *node = NULL;
+    if (arena->freeList != NULL) {
+        // reuse a released slot first
+        node = arena->freeList;
+        arena->freeList = node->left;
+    } else {
+        if (arena->slabs == NULL || arena->slabs->used == arena->slabs->capacity) {
+            // grow geometrically; live nodes never exceed AMOUNT_OF_POKEMON, so cap the total there
+            int capacity = (arena->slabs == NULL) ? POKEDEX_FIRST_SLAB_NODES : arena->slabs->capacity * 2;
+            if (arena->totalCapacity + capacity > AMOUNT_OF_POKEMON) {
+                capacity = AMOUNT_OF_POKEMON - arena->totalCapacity;
+            }
+            if (capacity < 1) {
+                capacity = 1;
+            }
+            PokedexSlab *slab = malloc(sizeof(PokedexSlab) + (size_t)capacity * sizeof(PokemonNode));
+            if (slab == NULL) {
+                outPrintf("Memory allocation failed.\n");
+                return NULL;
+            }
+            slab->capacity = capacity;
+            slab->used = 0;
+            slab->next = arena->slabs;
+            arena->slabs = slab;
+            arena->totalCapacity += capacity;
+        }
+        node = &arena->slabs->nodes[arena->slabs->used];
+        arena->slabs->used++;
+    }
+    node->data = data;
+    node->left = NULL;
+    node->right = NULL;
+    node->height = 1;
+    return node;
+}
+
+void freeArenaNode(PokedexArena *arena, PokemonNode *node) {
+    node->data = NULL;
+    node->right = NULL;
+    node->left = arena->freeList;
+    arena->freeList = node;
+}
+
+void releaseArena(PokedexArena *arena) {
+    PokedexSlab *slab = arena->slabs;
+    while (slab != NULL) {
+        PokedexSlab *next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    arena->slabs = NULL;
+    arena->totalCapacity = 0;
+    arena->freeList = NULL;
+}
+
+void openPokedexMenu() {
+    // get the new node's data
+    printPrompt("Your name: ");
+    char *ownerName = getDynamicInput();
+    if (ownerName == NULL) {
+        return;
+    }
+    if (inputExhausted) {
+        free(ownerName);
+        return;
+    }
+    if (findOwnerByName(ownerName) != NULL) {
+        // report the duplicate (and free the name) before asking for a starter
+        createPokedexFor(ownerName, 0);
+        return;
+    }
+    printPrompt("Choose Starter:\n1. Bulbasaur\n2. Charmander\n3. Squirtle\n");
+    int choice = readIntSafe("Your choice: ");
+    if (inputExhausted) {
+        free(ownerName);
+        return;
+    }
+    createPokedexFor(ownerName, choice);
+}
+
+void createPokedexFor(char *ownerName, int choice) {
+    if (findOwnerByName(ownerName) != NULL) {
+        outPrintf("Owner '%s' already exists. Not creating a new Pokedex.\n", ownerName);
+        free(ownerName);
+        return;
+    }
+    if (choice < BULBASAUR_OPT || choice > SQUIRTLE_OPT) {
+        outPrintf("Invalid choice.\n");
+        free(ownerName);
+        return;
+    }
+    int idOfChoice;
+    if (choice == BULBASAUR_OPT) {idOfChoice = BULBASAUR_ID;}
+    else if (choice == CHARMANDER_OPT) {idOfChoice = CHARMANDER_ID;}
+    else {idOfChoice = SQUIRTLE_ID;}
+
+    // create the new node and give it the last place in the circle
+    OwnerNode *newOwner = applyOpenOwner(ownerName, idOfChoice);
+    if (newOwner == NULL) {
+        free(ownerName);
+        return;
+    }
+    outPrintf("New Pokedex created for %s with starter %s.\n", newOwner->ownerName, newOwner->pokedexRoot->data->name);
+}
+
+void trimWhitespace(char *str)
+{
+    // Remove leading spaces/tabs/\r
+    int start = 0;
+    while (str[start] == ' ' || str[start] == '\t' || str[start] == '\r')
+        start++;
+
+    if (start > 0)
+    {
+        int idx = 0;
+        while (str[start])
+            str[idx++] = str[start++];
+        str[idx] = '\0';
+    }
+
+    // Remove trailing spaces/tabs/\r
+    int len = (int)strlen(str);
+    while (len > 0 && (str[len - 1] == ' ' || str[len - 1] == '\t' || str[len - 1] == '\r'))
+    {
+        str[--len] = '\0';
+    }
+}
+
+char *myStrdup(const char *src)
+{
+    if (!src)
+        return NULL;
+    size_t len = strlen(src);
+    char *dest = (char *)malloc(len + 1);
+    if (!dest)
+    {
+        outPrintf("Memory allocation failed in myStrdup.\n");
+        return NULL;
+    }
+    strcpy(dest, src);
+    return dest;
+}
+
+// Pull the next block from the reader's fd, keeping the unconsumed tail.
+// Returns 0 once nothing more can be read.
+static int refillInputReader(InputReader *reader)
+{
+    if (reader->eof)
+    {
+        return 0;
+    }
+    // slide the partial line to the front, grow only if it fills the whole buffer
+    if (reader->start > 0)
+    {
+        memmove(reader->buf, reader->buf + reader->start, reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
+    }
+    // keep one byte spare for the terminator of an unterminated last line
+    if (reader->buf == NULL || reader->end + 1 >= reader->capacity)
+    {
+        size_t newCapacity = reader->capacity ? reader->capacity * 2 : INPUT_BLOCK_SIZE;
+        char *temp = (char *)realloc(reader->buf, newCapacity);
+        if (!temp)
+        {
+            outPrintf("Memory allocation failed.\n");
+            reader->eof = 1;
+            return 0;
+        }
+        reader->buf = temp;
+        reader->capacity = newCapacity;
+    }
+    // everything done so far reaches the journal (one fsync for the whole batch),
+    // and whoever is waiting for this input must see the prompt first
+    commitJournal();
+    outFlush();
+    ssize_t got;
+    do
+    {
+        got = read(reader->fd, reader->buf + reader->end, reader->capacity - reader->end - 1);
+    } while (got < 0 && errno == EINTR);
+    if (got <= 0)
+    {
+        reader->eof = 1;
+        return 0;
+    }
+    reader->end += (size_t)got;
+    return 1;
+}
+
+char *readInputLine(InputReader *reader, size_t *length)
+{
+    size_t scanned = reader->start;
+    for (;;)
+    {
+        char *newline = NULL;
+        if (reader->end > scanned)
+        {
+            newline = memchr(reader->buf + scanned, '\n', reader->end - scanned);
+        }
+        if (newline)
+        {
+            char *line = reader->buf + reader->start;
+            *newline = '\0';
+            *length = (size_t)(newline - line);
+            reader->start = (size_t)(newline - reader->buf) + 1;
+            return line;
+        }
+        // no newline yet: remember how far we looked (relative to start, which may move)
+        size_t seen = reader->end - reader->start;
+        if (!refillInputReader(reader))
+        {
+            break;
+        }
+        scanned = reader->start + seen;
+    }
+    // end of input: a last line without '\n' still counts
+    if (reader->end > reader->start)
+    {
+        char *line = reader->buf + reader->start;
+        *length = reader->end - reader->start;
+        line[*length] = '\0';
+        reader->start = reader->end;
+        return line;
+    }
+    return NULL;
+}
+
+void trimLineView(char **line, size_t *length)
+{
+    char *str = *line;
+    size_t len = *length;
+    while (len > 0 && (*str == ' ' || *str == '\t' || *str == '\r'))
+    {
+        str++;
+        len--;
+    }
+    while (len > 0 && (str[len - 1] == ' ' || str[len - 1] == '\t' || str[len - 1] == '\r'))
+    {
+        len--;
+    }
+    str[len] = '\0';
+    *line = str;
+    *length = len;
+}
+
+void releaseInputReader(InputReader *reader)
+{
+    free(reader->buf);
+    reader->buf = NULL;
+    reader->capacity = 0;
+    reader->start = 0;
+    reader->end = 0;
+}
+
+int readIntSafe(const char *prompt)
+{
+    int value;
+    int success = 0;
+
+    while (!success)
+    {
+        printPrompt(prompt);
+
+        size_t len;
+        char *buffer = readInputLine(&stdinReader, &len);
+        // end of input: nothing more will ever come, so stop asking
+        if (buffer == NULL)
+        {
+            inputExhausted = 1;
+            return 0;
+        }
+
+        // 1) Strip a trailing \r
+        //    so "123\r\n" becomes "123"
+        if (len > 0 && buffer[len - 1] == '\r')
+            buffer[--len] = '\0';
+
+        // 2) Check if empty after stripping
+        if (len == 0)
+        {
+            outPrintf("Invalid input.\n");
+            continue;
+        }
+
+        // 3) Attempt to parse integer with strtol
+        char *endptr;
+        value = (int)strtol(buffer, &endptr, 10);
+
+        // If endptr didn't point to the end => leftover chars => invalid
+        // or if buffer was something non-numeric
+        if (*endptr != '\0')
+        {
+            outPrintf("Invalid input.\n");
+        }
+        else
+        {
+            // We got a valid integer
+            success = 1;
+        }
+    }
+    return value;
+}
+
+// --------------------------------------------------------------
+// 2) Utility: Get type name from enum
+// --------------------------------------------------------------
+const char *getTypeName(PokemonType type)
+{
+    switch (type)
+    {
+    case GRASS:
+        return "GRASS";
+    case FIRE:
+        return "FIRE";
+    case WATER:
+        return "WATER";
+    case BUG:
+        return "BUG";
+    case NORMAL:
+        return "NORMAL";
+    case POISON:
+        return "POISON";
+    case ELECTRIC:
+        return "ELECTRIC";
+    case GROUND:
+        return "GROUND";
+    case FAIRY:
+        return "FAIRY";
+    case FIGHTING:
+        return "FIGHTING";
+    case PSYCHIC:
+        return "PSYCHIC";
+    case ROCK:
+        return "ROCK";
+    case GHOST:
+        return "GHOST";
+    case DRAGON:
+        return "DRAGON";
+    case ICE:
+        return "ICE";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+// --------------------------------------------------------------
+// Utility: getDynamicInput (for reading a line into malloc'd memory)
+// --------------------------------------------------------------
+char *getDynamicInput()
+{
+    size_t size = 0;
+    char *line = readInputLine(&stdinReader, &size);
+    // end of input: there are no more lines, hand back an empty one
+    if (line == NULL)
+    {
+        inputExhausted = 1;
+        return myStrdup("");
+    }
+
+    // Trim any leading/trailing whitespace or carriage returns
+    trimLineView(&line, &size);
+
+    // one exact-size copy of the trimmed view
+    char *input = (char *)malloc(size + 1);
+    if (!input)
+    {
+        outPrintf("Memory allocation failed.\n");
+        return NULL;
+    }
+    memcpy(input, line, size);
+    input[size] = '\0';
+    return input;
+}
+
+// Function to print a single Pokemon node
+void printPokemonNode(PokemonNode *node)
+{
+    if (node == NULL) {
+        return;
+    }
+    if (node->data == NULL) {
+        return;
+    }
+    if (node->data->name == NULL) {
+        return;
+    }
+    // the whole line was formatted once at startup
+    int index = node->data->id - 1;
+    outWrite(speciesLines[index], speciesLineLength[index]);
+}
+
+void initPokedexTables(void)
+{
+    for (int i = 0; i < AMOUNT_OF_POKEMON; i++)
+    {
+        const PokemonData *data = &pokedex[i];
+        int length = snprintf(speciesLines[i], SPECIES_LINE_SIZE,
+                              "ID: %d, Name: %s, Type: %s, HP: %d, Attack: %d, Can Evolve: %s\n",
+                              data->id,
+                              data->name,
+                              getTypeName(data->TYPE),
+                              data->hp,
+                              data->attack,
+                              (data->CAN_EVOLVE == CAN_EVOLVE) ? "Yes" : "No");
+        speciesLineLength[i] = (size_t)length;
+    }
+
+    // stats as columns for filterSpecies
+    for (int i = 0; i < AMOUNT_OF_POKEMON; i++)
+    {
+        pokedexColumns.hp[i] = pokedex[i].hp;
+        pokedexColumns.attack[i] = pokedex[i].attack;
+        pokedexColumns.type[i] = (int)pokedex[i].TYPE;
+        pokedexColumns.canEvolve[i] = (int)pokedex[i].CAN_EVOLVE;
+    }
+
+    // fight scores, same formula (and float rounding) as a single fight always used
+    for (int i = 0; i < AMOUNT_OF_POKEMON; i++)
+    {
+        speciesScore[i] = ((float)pokedex[i].attack * (float)ATTACK_MODIFIER) +
+                          ((float)pokedex[i].hp * (float)HP_MODIFIER);
+    }
+
+    // rank the names once; displayAlphabetical never compares strings again
+    int byName[AMOUNT_OF_POKEMON];
+    for (int i = 0; i < AMOUNT_OF_POKEMON; i++)
+    {
+        byName[i] = i;
+    }
+    qsort(byName, AMOUNT_OF_POKEMON, sizeof(int), compareSpeciesByName);
+    for (int rank = 0; rank < AMOUNT_OF_POKEMON; rank++)
+    {
+        speciesNameRank[byName[rank]] = rank;
+    }
+}
+
+// --------------------------------------------------------------
+// Display Menu
+// --------------------------------------------------------------
+void displayMenu(OwnerNode *owner)
+{
+    if (!owner->pokedexRoot || !owner->pokedexRoot->data || !owner->pokedexRoot->data->name)
+    {
+        outPrintf("Pokedex is empty.\n");
+        return;
+    }
+
+    if (!batchMode) {
+        outPrintf("Display:\n");
+        outPrintf("1. BFS (Level-Order)\n");
+        outPrintf("2. Pre-Order\n");
+        outPrintf("3. In-Order\n");
+        outPrintf("4. Post-Order\n");
+        outPrintf("5. Alphabetical (by name)\n");
+        outPrintf("6. Filter by stats, type and evolution\n");
+        outPrintf("7. By type\n");
+    }
+
+    int choice = readIntSafe("Your choice: ");
+    if (inputExhausted) {
+        return;
+    }
+    displayPokedexAs(owner, choice);
+}
+
+void displayPokedexAs(OwnerNode *owner, int choice)
+{
+    // create function pointer as requirement
+    void (*printFunction)(PokemonNode *root) = printPokemonNode;
+
+    switch (choice)
+    {
+    case DISP_BFS_OPT:
+        displayBFS(owner->pokedexRoot, printFunction);
+        break;
+    case DISP_PRE_ORD_OPT:
+        preOrderTraversal(owner->pokedexRoot, printFunction);
+        break;
+    case DISP_IN_ORD_OPT:
+        inOrderTraversal(owner->pokedexRoot, printFunction);
+        break;
+    case DISP_POST_ORD_OPT:
+        postOrderTraversal(owner->pokedexRoot, printFunction);
+        break;
+    case DISP_ALPH_ORD_OPT:
+        displayAlphabetical(owner->pokedexRoot, printFunction);
+        break;
+    case DISP_STATS_OPT:
+        displayByStats(owner);
+        break;
+    case DISP_TYPE_OPT:
+        displayByType(owner);
+        break;
+    default:
+        outPrintf("Invalid choice.\n");
+    }
+}
+
+// --------------------------------------------------------------
+// Sub-menu for existing Pokedex
+// --------------------------------------------------------------
+void enterExistingPokedexMenu()
+{
+    // Check if there are any owners
+    if (ownerHead == NULL) {
+        outPrintf("No existing Pokedexes.\n");
+        return;
+    }
+
+    // list owners
+    printPrompt("\nExisting Pokedexes:\n");
+
+    // get user input for which owner by list number starting at 1
+    // (wraps around if ownerChoice exceeds the number of owners)
+    int ownerChoice = readOwnerChoice("Choose a Pokedex by number: ");
+    if (inputExhausted) {
+        return;
+    }
+    OwnerNode *cur = getOwnerByNumber(ownerChoice);
+
+    outPrintf("\nEntering %s's Pokedex...\n", cur->ownerName);
+
+    int subChoice;
+    do
+    {
+        if (!batchMode) {
+            outPrintf("\n-- %s's Pokedex Menu --\n", cur->ownerName);
+            outPrintf("1. Add Pokemon\n");
+            outPrintf("2. Display Pokedex\n");
+            outPrintf("3. Release Pokemon (by ID)\n");
+            outPrintf("4. Pokemon Fight!\n");
+            outPrintf("5. Evolve Pokemon\n");
+            outPrintf("6. Back to Main\n");
+            outPrintf("7. Tournament (everyone fights everyone)\n");
+            outPrintf("8. Bulk add Pokemon (IDs and ranges)\n");
+        }
+
+        subChoice = readIntSafe("Your choice: ");
+        // out of input: leave the menu like "Back", just without the message
+        if (inputExhausted) {
+            break;
+        }
+
+        switch (subChoice)
+        {
+        case OWN_ADD_OPT:
+            addPokemon(cur);
+            break;
+        case OWN_DISP_OPT:
+            displayMenu(cur);
+            break;
+        case OWN_FREE_OPT:
+            if (!cur->pokedexRoot || !cur->pokedexRoot->data) {
+                outPrintf("No Pokemon to release.\n");
+                break;
+            }
+            freePokemon(cur);
+            break;
+        case OWN_FIGHT_OPT:
+            if (cur->pokedexRoot == NULL) {
+                outPrintf("Pokedex is empty.\n");
+                break;
+            }
+            pokemonFight(cur);
+            break;
+        case OWN_EVOLVE_OPT:
+            if (cur->pokedexRoot == NULL) {
+                outPrintf("Cannot evolve. Pokedex empty.\n");
+                break;
+            }
+            evolvePokemon(cur);
+            break;
+        case OWN_TOURNAMENT_OPT:
+            if (cur->pokedexRoot == NULL) {
+                outPrintf("Pokedex is empty.\n");
+                break;
+            }
+            pokemonTournament(cur);
+            break;
+        case OWN_BULK_ADD_OPT:
+            bulkAddPokemon(cur);
+            break;
+        case OWN_BACK_OPT:
+            outPrintf("Back to Main Menu.\n");
+            break;
+        default:
+            outPrintf("Invalid choice.\n");
+        }
+    } while (subChoice != 6);
+}
+
+// --------------------------------------------------------------
+// Snapshots: the whole owner ring in one compact binary file
+// --------------------------------------------------------------
+static unsigned char *putU32(unsigned char *out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        out[i] = (unsigned char)(value >> (8 * i));
+    }
+    return out + 4;
+}
+
+static unsigned char *putU64(unsigned char *out, uint64_t value)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        out[i] = (unsigned char)(value >> (8 * i));
+    }
+    return out + 8;
+}
+
+static uint32_t getU32(const unsigned char *in)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        value |= (uint32_t)in[i] << (8 * i);
+    }
+    return value;
+}
+
+static uint64_t getU64(const unsigned char *in)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        value |= (uint64_t)in[i] << (8 * i);
+    }
+    return value;
+}
+
+int fillOwnerFromMask(OwnerNode *owner, const SpeciesMask *mask)
+{
+    PokemonNode *nodes[AMOUNT_OF_POKEMON];
+    int count = 0;
+    int ok = 1;
+    // set bits come out in ID order, which is exactly the in-order sequence of the tree
+    for (int id = 1; id <= AMOUNT_OF_POKEMON; id++)
+    {
+        if (!hasSpeciesBit(mask, id))
+        {
+            continue;
+        }
+        PokemonNode *node = allocArenaNode(&owner->arena, &pokedex[id - 1]);
+        if (node == NULL)
+        {
+            ok = 0;
+            break;
+        }
+        owner->pokemonByID[id] = node;
+        markSpeciesHeld(owner, id);
+        nodes[count++] = node;
+    }
+    owner->pokedexRoot = buildBalancedTree(nodes, count);
+    return ok;
+}
+
+int saveSnapshot(const char *path)
+{
+    // one buffer for the whole file, one write
+    size_t size = 12;
+    for (int i = 0; i < ownerDirectory.count; i++)
+    {
+        size += 4 + strlen(ownerDirectory.owners[i]->ownerName) + 8 * SPECIES_MASK_WORDS;
+    }
+    unsigned char *buffer = malloc(size);
+    if (buffer == NULL)
+    {
+        outPrintf("Memory allocation failed.\n");
+        return -1;
+    }
+    unsigned char *out = buffer;
+    memcpy(out, SNAPSHOT_MAGIC, 4);
+    out = putU32(out + 4, SNAPSHOT_VERSION);
+    out = putU32(out, (uint32_t)ownerDirectory.count);
+    for (int i = 0; i < ownerDirectory.count; i++)
+    {
+        const OwnerNode *owner = ownerDirectory.owners[i];
+        size_t nameLength = strlen(owner->ownerName);
+        out = putU32(out, (uint32_t)nameLength);
+        memcpy(out, owner->ownerName, nameLength);
+        out += nameLength;
+        for (int w = 0; w < SPECIES_MASK_WORDS; w++)
+        {
+            out = putU64(out, owner->heldMask.words[w]);
+        }
+    }
+
+    // write next to the target and rename over it, so a crash never leaves half a snapshot
+    size_t pathLength = strlen(path);
+    char *tempPath = malloc(pathLength + 5);
+    if (tempPath == NULL)
+    {
+        outPrintf("Memory allocation failed.\n");
+        free(buffer);
+        return -1;
+    }
+    memcpy(tempPath, path, pathLength);
+    memcpy(tempPath + pathLength, ".tmp", 5);
+    int result = -1;
+    int fd = open(tempPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0)
+    {
+        if (writeAll(fd, (const char *)buffer, size) == 0 && fsync(fd) == 0)
+        {
+            result = ownerDirectory.count;
+        }
+        close(fd);
+        if (result >= 0 && rename(tempPath, path) != 0)
+        {
+            result = -1;
+        }
+        if (result < 0)
+        {
+            unlink(tempPath);
+        }
+    }
+    free(tempPath);
+    free(buffer);
+    return result;
+}
+
+// Check the whole file before touching any owner. Returns the owner count, or -1.
+static long validateSnapshot(const unsigned char *data, size_t size)
+{
+    if (size < 12 || memcmp(data, SNAPSHOT_MAGIC, 4) != 0 || getU32(data + 4) != SNAPSHOT_VERSION)
+    {
+        return -1;
+    }
+    uint32_t count = getU32(data + 8);
+    size_t offset = 12;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (size - offset < 4)
+        {
+            return -1;
+        }
+        uint32_t nameLength = getU32(data + offset);
+        offset += 4;
+        if (size - offset < (size_t)nameLength + 8 * SPECIES_MASK_WORDS ||
+            memchr(data + offset, '\0', nameLength) != NULL)
+        {
+            return -1;
+        }
+        offset += nameLength;
+        // no bits past the last species
+        uint64_t last = getU64(data + offset + 8 * (SPECIES_MASK_WORDS - 1));
+        if (AMOUNT_OF_POKEMON % 64 != 0 && (last >> (AMOUNT_OF_POKEMON % 64)) != 0)
+        {
+            return -1;
+        }
+        offset += 8 * SPECIES_MASK_WORDS;
+    }
+    return (offset == size) ? (long)count : -1;
+}
+
+int loadSnapshot(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < 12)
+    {
+        close(fd);
+        return -1;
+    }
+    size_t size = (size_t)info.st_size;
+    unsigned char *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return -1;
+    }
+    long count = validateSnapshot(data, size);
+    if (count < 0)
+    {
+        munmap(data, size);
+        return -1;
+    }
+
+    // the file is good: replace everything
+    freeAllOwners();
+    journalRecord(JOURNAL_RESET, NULL, 0);
+    int loaded = 0;
+    size_t offset = 12;
+    for (long i = 0; i < count; i++)
+    {
+        uint32_t nameLength = getU32(data + offset);
+        offset += 4;
+        char *name = malloc((size_t)nameLength + 1);
+        if (name == NULL)
+        {
+            outPrintf("Memory allocation failed.\n");
+            break;
+        }
+        memcpy(name, data + offset, nameLength);
+        name[nameLength] = '\0';
+        offset += nameLength;
+        SpeciesMask mask;
+        for (int w = 0; w < SPECIES_MASK_WORDS; w++)
+        {
+            mask.words[w] = getU64(data + offset);
+            offset += 8;
+        }
+        if (findOwnerByName(name) != NULL)
+        {
+            outPrintf("Owner '%s' appears twice, keeping the first.\n", name);
+            free(name);
+            continue;
+        }
+        OwnerNode *owner = createOwner(name, 0);
+        if (owner == NULL)
+        {
+            free(name);
+            break;
+        }
+        fillOwnerFromMask(owner, &mask);
+        linkOwnerInCircularList(owner);
+        // the journal gets the owner itself, the snapshot file may be gone by replay time
+        journalOwner(owner);
+        loaded++;
+    }
+    munmap(data, size);
+    return loaded;
+}
+
+void saveSnapshotMenu(void)
+{
+    printPrompt("Snapshot file: ");
+    char *path = getDynamicInput();
+    if (path == NULL)
+    {
+        return;
+    }
+    if (inputExhausted)
+    {
+        free(path);
+        return;
+    }
+    saveSnapshotTo(path);
+    free(path);
+}
+
+void saveSnapshotTo(const char *path)
+{
+    int saved = saveSnapshot(path);
+    if (saved < 0)
+    {
+        outPrintf("Could not save snapshot to %s.\n", path);
+    }
+    else
+    {
+        outPrintf("Saved %d owner(s) to %s.\n", saved, path);
+    }
+}
+
+void loadSnapshotMenu(void)
+{
+    printPrompt("Snapshot file: ");
+    char *path = getDynamicInput();
+    if (path == NULL)
+    {
+        return;
+    }
+    if (inputExhausted)
+    {
+        free(path);
+        return;
+    }
+    loadSnapshotFrom(path);
+    free(path);
+}
+
+void loadSnapshotFrom(const char *path)
+{
+    int loaded = loadSnapshot(path);
+    if (loaded < 0)
+    {
+        outPrintf("Could not load snapshot from %s.\n", path);
+    }
+    else
+    {
+        outPrintf("Loaded %d owner(s) from %s.\n", loaded, path);
+    }
+}
+
+// --------------------------------------------------------------
+// Mutations: every change to the owners, each logged as one journal record
+// --------------------------------------------------------------
+// Reserve a record for payloadLength bytes; returns where the payload goes, or NULL when not logging.
+// Holds journalLock until journalEnd, so records of owners changed in parallel never interleave.
+static unsigned char *journalBegin(JournalOp op, size_t payloadLength)
+{
+    if (journal.fd < 0 || journal.replaying)
+    {
+        return NULL;
+    }
+    pthread_mutex_lock(&journalLock);
+    size_t needed = journal.length + 4 + 1 + payloadLength + 4;
+    if (needed > journal.capacity)
+    {
+        size_t capacity = journal.capacity ? journal.capacity : OUTPUT_BLOCK_SIZE;
+        while (capacity < needed)
+        {
+            capacity *= 2;
+        }
+        unsigned char *grown = realloc(journal.buf, capacity);
+        if (grown == NULL)
+        {
+            pthread_mutex_unlock(&journalLock);
+            outPrintf("Memory allocation failed.\n");
+            return NULL;
+        }
+        journal.buf = grown;
+        journal.capacity = capacity;
+    }
+    unsigned char *record = journal.buf + journal.length;
+    putU32(record, (uint32_t)payloadLength);
+    record[4] = (unsigned char)op;
+    return record + 5;
+}
+
+static uint32_t journalChecksum(const unsigned char *bytes, size_t length)
+{
+    // 32-bit FNV-1a, same as owner names
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Seal the record started by journalBegin
+static void journalEnd(size_t payloadLength)
+{
+    unsigned char *record = journal.buf + journal.length;
+    putU32(record + 5 + payloadLength, journalChecksum(record + 4, 1 + payloadLength));
+    journal.length += 4 + 1 + payloadLength + 4;
+    journal.sealed += 4 + 1 + payloadLength + 4;
+    journalSealedHere = journal.sealed;
+    pthread_mutex_unlock(&journalLock);
+}
+
+void journalRecord(JournalOp op, const unsigned char *payload, size_t length)
+{
+    unsigned char *out = journalBegin(op, length);
+    if (out == NULL)
+    {
+        return;
+    }
+    if (length > 0)
+    {
+        memcpy(out, payload, length);
+    }
+    journalEnd(length);
+}
+
+static void journalPair(JournalOp op, int first, int second)
+{
+    unsigned char payload[8];
+    putU32(putU32(payload, (uint32_t)first), (uint32_t)second);
+    journalRecord(op, payload, sizeof(payload));
+}
+
+void journalOwner(const OwnerNode *owner)
+{
+    size_t nameLength = strlen(owner->ownerName);
+    size_t length = 8 * SPECIES_MASK_WORDS + nameLength;
+    unsigned char *out = journalBegin(JOURNAL_OWNER, length);
+    if (out == NULL)
+    {
+        return;
+    }
+    for (int w = 0; w < SPECIES_MASK_WORDS; w++)
+    {
+        out = putU64(out, owner->heldMask.words[w]);
+    }
+    memcpy(out, owner->ownerName, nameLength);
+    journalEnd(length);
+}
+
+OwnerNode *applyOpenOwner(char *ownerName, int starterID)
+{
+    OwnerNode *owner = createOwner(ownerName, starterID);
+    if (owner == NULL)
+    {
+        return NULL;
+    }
+    linkOwnerInCircularList(owner);
+    size_t nameLength = strlen(ownerName);
+    unsigned char *out = journalBegin(JOURNAL_OPEN, 4 + nameLength);
+    if (out != NULL)
+    {
+        memcpy(putU32(out, (uint32_t)starterID), ownerName, nameLength);
+        journalEnd(4 + nameLength);
+    }
+    return owner;
+}
+
+int applyAddPokemon(OwnerNode *owner, int id)
+{
+    int status = addPokemonToOwner(owner, id);
+    if (status == 1)
+    {
+        journalPair(JOURNAL_ADD, owner->position, id);
+    }
+    return status;
+}
+
+int applyReleasePokemon(OwnerNode *owner, int id)
+{
+    if (findPokemonInOwner(owner, id) == NULL)
+    {
+        return 0;
+    }
+    journalPair(JOURNAL_RELEASE, owner->position, id);
+    releasePokemonFromOwner(owner, id);
+    return 1;
+}
+
+int applyEvolvePokemon(OwnerNode *owner, int id)
+{
+    PokemonNode *node = findPokemonInOwner(owner, id);
+    if (node == NULL || node->data->CAN_EVOLVE == CANNOT_EVOLVE)
+    {
+        return 0;
+    }
+    journalPair(JOURNAL_EVOLVE, owner->position, id);
+    // remove ID from tree, and add ID + 1 to tree
+    releasePokemonFromOwner(owner, id);
+    addPokemonToOwner(owner, id + 1);
+    return 1;
+}
+
+void applyMergeOwners(OwnerNode *target, OwnerNode *source)
+{
+    // positions as they are before the source leaves the ring
+    journalPair(JOURNAL_MERGE, target->position, source->position);
+    mergeOwnerPokedexes(target, source);
+    removeOwnerFromCircularList(source);
+    freeOwnerNode(source);
+}
+
+int applyBulkMerge(OwnerNode *target, OwnerNode **sources, int count)
+{
+    // positions as they are before the sources leave the ring, written straight into the journal;
+    // if there is no room for the record, nothing is merged
+    size_t length = 4 * ((size_t)count + 1);
+    unsigned char *out = journalBegin(JOURNAL_BULK_MERGE, length);
+    if (out == NULL && journal.fd >= 0 && !journal.replaying)
+    {
+        return 0;
+    }
+    if (out != NULL)
+    {
+        out = putU32(out, (uint32_t)target->position);
+        for (int i = 0; i < count; i++)
+        {
+            out = putU32(out, (uint32_t)sources[i]->position);
+        }
+        journalEnd(length);
+    }
+
+    SpeciesMask all;
+    unionHeldMasks(sources, count, &all);
+    addSpeciesMaskToOwner(target, &all);
+
+    // unlink every source (O(1) each), then renumber the survivors once
+    for (int i = 0; i < count; i++)
+    {
+        OwnerNode *source = sources[i];
+        unregisterOwner(source);
+        if (source == ownerHead)
+        {
+            ownerHead = source->next;
+        }
+        source->prev->next = source->next;
+        source->next->prev = source->prev;
+        freeOwnerNode(source);
+    }
+    rebuildOwnerDirectory();
+    return 1;
+}
+
+int applyBulkAdd(OwnerNode *owner, const SpeciesMask *mask)
+{
+    // only the IDs not held yet are logged
+    SpeciesMask wanted = *mask;
+    for (int w = 0; w < SPECIES_MASK_WORDS; w++)
+    {
+        wanted.words[w] &= ~owner->heldMask.words[w];
+    }
+    int added = addSpeciesMaskToOwner(owner, &wanted);
+    if (added > 0)
+    {
+        // what actually went in (less than wanted only if memory ran out)
+        unsigned char payload[4 + 8 * SPECIES_MASK_WORDS];
+        unsigned char *out = putU32(payload, (uint32_t)owner->position);
+        for (int w = 0; w < SPECIES_MASK_WORDS; w++)
+        {
+            out = putU64(out, wanted.words[w] & owner->heldMask.words[w]);
+        }
+        journalRecord(JOURNAL_BULK_ADD, payload, sizeof(payload));
+    }
+    return added;
+}
+
+void applyDeleteOwner(OwnerNode *owner)
+{
+    unsigned char payload[4];
+    putU32(payload, (uint32_t)owner->position);
+    journalRecord(JOURNAL_DELETE, payload, sizeof(payload));
+    removeOwnerFromCircularList(owner);
+    freeOwnerNode(owner);
+}
+
+void applySortOwners(void)
+{
+    if (ownerHead == NULL || ownerHead->next == ownerHead)
+    {
+        return;
+    }
+    journalRecord(JOURNAL_SORT, NULL, 0);
+    // open the circle into a plain chain starting at the head
+    ownerHead->prev->next = NULL;
+    ownerHead = mergeSortOwnerList(ownerHead);
+
+    // walk the sorted chain once to restore prev links, then close the circle again
+    OwnerNode *current = ownerHead;
+    while (current->next != NULL)
+    {
+        current->next->prev = current;
+        current = current->next;
+    }
+    current->next = ownerHead;
+    ownerHead->prev = current;
+    // every list number changed
+    rebuildOwnerDirectory();
+}
+
+void commitJournal(void)
+{
+    if (journal.fd < 0 || journal.length == 0)
+    {
+        return;
+    }
+    if (writeAll(journal.fd, (const char *)journal.buf, journal.length) != 0 || fsync(journal.fd) != 0)
+    {
+        fprintf(stderr, "Journal write failed.\n");
+    }
+    journal.length = 0;
+}
+
+static OwnerNode *ownerAtPosition(uint32_t position)
+{
+    return (position < (uint32_t)ownerDirectory.count) ? ownerDirectory.owners[position] : NULL;
+}
+
+// Apply one journal record. Returns 0 if it doesn't fit the current state (damaged journal).
+static int replayRecord(JournalOp op, const unsigned char *payload, size_t length)
+{
+    switch (op)
+    {
+    case JOURNAL_OPEN:
+    case JOURNAL_OWNER:
+    {
+        size_t skip = (op == JOURNAL_OPEN) ? 4 : 8 * SPECIES_MASK_WORDS;
+        if (length < skip || memchr(payload + skip, '\0', length - skip) != NULL)
+        {
+            return 0;
+        }
+        char *name = malloc(length - skip + 1);
+        if (name == NULL)
+        {
+            return 0;
+        }
+        memcpy(name, payload + skip, length - skip);
+        name[length - skip] = '\0';
+        if (findOwnerByName(name) != NULL)
+        {
+            free(name);
+            return 0;
+        }
+        OwnerNode *owner;
+        if (op == JOURNAL_OPEN)
+        {
+            owner = applyOpenOwner(name, (int)getU32(payload));
+        }
+        else
+        {
+            SpeciesMask mask;
+            for (int w = 0; w < SPECIES_MASK_WORDS; w++)
+            {
+                mask.words[w] = getU64(payload + 8 * w);
+            }
+            if (AMOUNT_OF_POKEMON % 64 != 0 && (mask.words[SPECIES_MASK_WORDS - 1] >> (AMOUNT_OF_POKEMON % 64)) != 0)
+            {
+                free(name);
+                return 0;
+            }
+            owner = createOwner(name, 0);
+            if (owner != NULL)
+            {
+                fillOwnerFromMask(owner, &mask);
+                linkOwnerInCircularList(owner);
+            }
+        }
+        if (owner == NULL)
+        {
+            free(name);
+            return 0;
+        }
+        return 1;
+    }
+    case JOURNAL_ADD:
+    case JOURNAL_RELEASE:
+    case JOURNAL_EVOLVE:
+    case JOURNAL_MERGE:
+    {
+        if (length != 8)
+        {
+            return 0;
+        }
+        OwnerNode *owner = ownerAtPosition(getU32(payload));
+        uint32_t second = getU32(payload + 4);
+        if (owner == NULL)
+        {
+            return 0;
+        }
+        if (op == JOURNAL_ADD)
+        {
+            return applyAddPokemon(owner, (int)second) == 1;
+        }
+        if (op == JOURNAL_RELEASE)
+        {
+            return applyReleasePokemon(owner, (int)second);
+        }
+        if (op == JOURNAL_EVOLVE)
+        {
+            return applyEvolvePokemon(owner, (int)second);
+        }
+        OwnerNode *source = ownerAtPosition(second);
+        if (source == NULL || source == owner)
+        {
+            return 0;
+        }
+        applyMergeOwners(owner, source);
+        return 1;
+    }
+    case JOURNAL_BULK_MERGE:
+    {
+        OwnerNode *target = (length >= 8 && length % 4 == 0) ? ownerAtPosition(getU32(payload)) : NULL;
+        if (target == NULL)
+        {
+            return 0;
+        }
+        int count = (int)(length / 4) - 1;
+        OwnerNode **sources = malloc((size_t)count * sizeof(OwnerNode *));
+        unsigned char *chosen = calloc((size_t)ownerDirectory.count, 1);
+        int ok = (sources != NULL && chosen != NULL);
+        if (ok)
+        {
+            chosen[target->position] = 1;
+        }
+        for (int i = 0; ok && i < count; i++)
+        {
+            sources[i] = ownerAtPosition(getU32(payload + 4 * (i + 1)));
+            // every source must exist, once, and not be the target
+            ok = (sources[i] != NULL && !chosen[sources[i]->position]);
+            if (ok)
+            {
+                chosen[sources[i]->position] = 1;
+            }
+        }
+        if (ok)
+        {
+            ok = applyBulkMerge(target, sources, count);
+        }
+        free(sources);
+        free(chosen);
+        return ok;
+    }
+    case JOURNAL_BULK_ADD:
+    {
+        OwnerNode *owner = (length == 4 + 8 * SPECIES_MASK_WORDS) ? ownerAtPosition(getU32(payload)) : NULL;
+        if (owner == NULL)
+        {
+            return 0;
+        }
+        SpeciesMask mask;
+        for (int w = 0; w < SPECIES_MASK_WORDS; w++)
+        {
+            mask.words[w] = getU64(payload + 4 + 8 * w);
+        }
+        return applyBulkAdd(owner, &mask) > 0;
+    }
+    case JOURNAL_DELETE:
+    {
+        OwnerNode *owner = (length == 4) ? ownerAtPosition(getU32(payload)) : NULL;
+        if (owner == NULL)
+        {
+            return 0;
+        }
+        applyDeleteOwner(owner);
+        return 1;
+    }
+    case JOURNAL_SORT:
+        applySortOwners();
+        return length == 0;
+    case JOURNAL_RESET:
+        freeAllOwners();
+        return length == 0;
+    default:
+        return 0;
+    }
+}
+
+int openJournal(const char *path)
+{
+    int fd = open(path, O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    size_t size = (size_t)info.st_size;
+    size_t offset = 0;
+    int replayed = 0;
+    int rejected = 0;
+    if (size > 0)
+    {
+        const unsigned char *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            close(fd);
+            return -1;
+        }
+        // replay quietly: the ops print as if a user were watching
+        OutputSink *visibleSink = outputSink;
+        static OutputSink discardSink = {-1, 0, NULL, 0, 0, 0, 0, {0}};
+        outputSink = &discardSink;
+        journal.replaying = 1;
+        while (size - offset >= 9)
+        {
+            size_t length = getU32(data + offset);
+            if (length > size - offset - 9 ||
+                journalChecksum(data + offset + 4, 1 + length) != getU32(data + offset + 5 + length))
+            {
+                break;
+            }
+            // an intact record that doesn't fit is not damage: the journal and this build disagree
+            if (!replayRecord((JournalOp)data[offset + 4], data + offset + 5, length))
+            {
+                rejected = 1;
+                break;
+            }
+            offset += 9 + length;
+            replayed++;
+        }
+        journal.replaying = 0;
+        outFlush();
+        outputSink = visibleSink;
+        munmap((void *)data, size);
+    }
+    if (rejected)
+    {
+        // stop before anything is written, so the history is still there to look at
+        fprintf(stderr, "Journal: record %d (byte %lu) does not apply to the replayed owners; file left unchanged.\n",
+                replayed + 1, (unsigned long)offset);
+        close(fd);
+        return -1;
+    }
+    // a torn or damaged tail is cut off so new records follow the last good one
+    if (offset < size)
+    {
+        fprintf(stderr, "Journal: dropped %lu damaged byte(s) after %d record(s).\n",
+                (unsigned long)(size - offset), replayed);
+        if (ftruncate(fd, (off_t)offset) != 0)
+        {
+            close(fd);
+            return -1;
+        }
+    }
+    journal.fd = fd;
+    return replayed;
+}
+
+void closeJournal(void)
+{
+    commitJournal();
+    if (journal.fd >= 0)
+    {
+        close(journal.fd);
+        journal.fd = -1;
+    }
+    free(journal.buf);
+    journal.buf = NULL;
+    journal.length = 0;
+    journal.capacity = 0;
+}
+
+// --------------------------------------------------------------
+// Server mode: a line protocol over a Unix domain socket
+// --------------------------------------------------------------
+// Cut the next space-separated word off the line ("" when none is left)
+static char *takeWord(char **cursor)
+{
+    char *word = *cursor;
+    while (*word == ' ' || *word == '\t')
+    {
+        word++;
+    }
+    char *end = word;
+    while (*end != '\0' && *end != ' ' && *end != '\t')
+    {
+        end++;
+    }
+    if (*end != '\0')
+    {
+        *end++ = '\0';
+    }
+    *cursor = end;
+    return word;
+}
+
+// Cut the next word off the line as a number; 0 if it isn't one
+static int takeNumber(char **cursor, int *value)
+{
+    char *word = takeWord(cursor);
+    char *end;
+    long number = strtol(word, &end, 10);
+    if (*word == '\0' || *end != '\0' || number < INT_MIN || number > INT_MAX)
+    {
+        return 0;
+    }
+    *value = (int)number;
+    return 1;
+}
+
+// Cut count numbers off the line; 0 if any of them isn't one
+static int takeNumbers(char **cursor, int *values, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (!takeNumber(cursor, &values[i]))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// The owner named by the rest of the line; says so and returns NULL if there is none.
+// With `locked`, the owner's lock is taken (exclusive to change it) and the owner stored there.
+static OwnerNode *takeOwner(char *rest, int exclusive, OwnerNode **locked)
+{
+    trimWhitespace(rest);
+    OwnerNode *owner = findOwnerByName(rest);
+    if (owner == NULL)
+    {
+        outPrintf("No owner named '%s'.\n", rest);
+        return NULL;
+    }
+    if (locked != NULL)
+    {
+        if (exclusive)
+        {
+            pthread_rwlock_wrlock(&owner->lock);
+        }
+        else
+        {
+            pthread_rwlock_rdlock(&owner->lock);
+        }
+        *locked = owner;
+    }
+    return owner;
+}
+
+static void printServerHelp(void)
+{
+    outPrintf("NEW <starter 1-3> <name>\nLIST\nDELETE <name>\nMERGE <first>,<second>\n"
+              "MERGEALL <target>,<source>,<source>,...\nSORT\n"
+              "PRINT <F|B> <count>\nFIND <id>\nRARITY\nSAVE <path>\nLOAD <path>\n"
+              "ADD <id> <name>\nBULKADD <ids, e.g. 1-10,25> <name>\nRELEASE <id> <name>\nFIGHT <id1> <id2> <name>\nEVOLVE <id> <name>\n"
+              "DISPLAY <1-5> <name>\n"
+              "FILTER <min HP> <max HP> <min Attack> <max Attack> <type 0-15> <evolves 0-2> <name> (0: no limit / any)\n"
+              "BYTYPE <type 1-15> <name>\n"
+              "TOURNAMENT <name>\nHELP\nQUIT\n");
+}
+
+// One command, with ringLock already held (exclusive for the commands that need it)
+static int runServerCommand(char *command, char *rest, OwnerNode **locked)
+{
+    int first = 0;
+    int second = 0;
+    int third = 0;
+    int filterArgs[6];
+    OwnerNode *owner;
+
+    if (strcmp(command, "QUIT") == 0)
+    {
+        outPrintf("Goodbye!\n");
+        return 1;
+    }
+    if (strcmp(command, "HELP") == 0)
+    {
+        printServerHelp();
+    }
+    else if (strcmp(command, "NEW") == 0 && takeNumber(&rest, &first))
+    {
+        trimWhitespace(rest);
+        char *ownerName = myStrdup(rest);
+        if (ownerName == NULL)
+        {
+            outPrintf("Memory allocation failed.\n");
+            return 0;
+        }
+        createPokedexFor(ownerName, first);
+    }
+    else if (strcmp(command, "LIST") == 0)
+    {
+        if (ownerHead == NULL)
+        {
+            outPrintf("No existing Pokedexes.\n");
+        }
+        printAllOwners();
+    }
+    else if (strcmp(command, "DELETE") == 0)
+    {
+        if ((owner = takeOwner(rest, 0, NULL)) != NULL)
+        {
+            deletePokedexOf(owner);
+        }
+    }
+    else if (strcmp(command, "MERGE") == 0 && strchr(rest, ',') != NULL)
+    {
+        char *secondUser = strchr(rest, ',');
+        *secondUser++ = '\0';
+        trimWhitespace(rest);
+        trimWhitespace(secondUser);
+        if (ownerHead == NULL || ownerHead->next == ownerHead)
+        {
+            outPrintf("Not enough owners to merge.\n");
+            return 0;
+        }
+        mergePokedexesOf(rest, secondUser);
+    }
+    else if (strcmp(command, "MERGEALL") == 0 && strchr(rest, ',') != NULL)
+    {
+        char *sourceNames = strchr(rest, ',');
+        *sourceNames++ = '\0';
+        trimWhitespace(rest);
+        bulkMergePokedexesInto(rest, sourceNames);
+    }
+    else if (strcmp(command, "SORT") == 0)
+    {
+        sortOwners();
+    }
+    else if (strcmp(command, "PRINT") == 0)
+    {
+        char *direction = takeWord(&rest);
+        if (ownerHead == NULL)
+        {
+            outPrintf("No owners.\n");
+        }
+        else if ((strcmp(direction, "F") == 0 || strcmp(direction, "B") == 0) && takeNumber(&rest, &first))
+        {
+            if (first > SERVER_MAX_PRINT)
+            {
+                outPrintf("Count must be at most %d.\n", SERVER_MAX_PRINT);
+            }
+            else
+            {
+                printOwnersInDirection(direction[0] == 'F', first);
+            }
+        }
+        else
+        {
+            outPrintf("Invalid direction, must be F or B.\n");
+        }
+    }
+    else if (strcmp(command, "FIND") == 0 && takeNumber(&rest, &first))
+    {
+        pthread_mutex_lock(&holdersLock);
+        printHoldersOf(first);
+        pthread_mutex_unlock(&holdersLock);
+    }
+    else if (strcmp(command, "RARITY") == 0)
+    {
+        pthread_mutex_lock(&holdersLock);
+        printRarityReport();
+        pthread_mutex_unlock(&holdersLock);
+    }
+    else if (strcmp(command, "SAVE") == 0)
+    {
+        trimWhitespace(rest);
+        saveSnapshotTo(rest);
+    }
+    else if (strcmp(command, "LOAD") == 0)
+    {
+        trimWhitespace(rest);
+        loadSnapshotFrom(rest);
+    }
+    else if (strcmp(command, "ADD") == 0 && takeNumber(&rest, &first))
+    {
+        if ((owner = takeOwner(rest, 1, locked)) != NULL)
+        {
+            addPokemonByID(owner, first);
+        }
+    }
+    else if (strcmp(command, "BULKADD") == 0)
+    {
+        char *idList = takeWord(&rest);
+        if ((owner = takeOwner(rest, 1, locked)) != NULL)
+        {
+            bulkAddPokemonByIDs(owner, idList);
+        }
+    }
+    else if (strcmp(command, "RELEASE") == 0 && takeNumber(&rest, &first))
+    {
+        if ((owner = takeOwner(rest, 1, locked)) == NULL)
+        {
+            return 0;
+        }
+        if (owner->pokedexRoot == NULL)
+        {
+            outPrintf("No Pokemon to release.\n");
+            return 0;
+        }
+        releasePokemonByID(owner, first);
+    }
+    else if (strcmp(command, "FIGHT") == 0 && takeNumber(&rest, &first) && takeNumber(&rest, &second))
+    {
+        if ((owner = takeOwner(rest, 0, locked)) == NULL)
+        {
+            return 0;
+        }
+        if (owner->pokedexRoot == NULL)
+        {
+            outPrintf("Pokedex is empty.\n");
+            return 0;
+        }
+        fightPokemonByID(owner, first, second);
+    }
+    else if (strcmp(command, "EVOLVE") == 0 && takeNumber(&rest, &first))
+    {
+        if ((owner = takeOwner(rest, 1, locked)) == NULL)
+        {
+            return 0;
+        }
+        if (owner->pokedexRoot == NULL)
+        {
+            outPrintf("Cannot evolve. Pokedex empty.\n");
+            return 0;
+        }
+        evolvePokemonByID(owner, first);
+    }
+    else if (strcmp(command, "DISPLAY") == 0 && takeNumber(&rest, &first))
+    {
+        if ((owner = takeOwner(rest, 0, locked)) == NULL)
+        {
+            return 0;
+        }
+        if (owner->pokedexRoot == NULL)
+        {
+            outPrintf("Pokedex is empty.\n");
+            return 0;
+        }
+        // 6 and 7 ask for more input; the server has FILTER and BYTYPE for them
+        if (first < DISP_BFS_OPT || first > DISP_ALPH_ORD_OPT)
+        {
+            outPrintf("Invalid choice.\n");
+            return 0;
+        }
+        displayPokedexAs(owner, first);
+    }
+    else if (strcmp(command, "FILTER") == 0 && takeNumbers(&rest, filterArgs, 6))
+    {
+        if ((owner = takeOwner(rest, 0, locked)) == NULL)
+        {
+            return 0;
+        }
+        if (owner->pokedexRoot == NULL)
+        {
+            outPrintf("Pokedex is empty.\n");
+            return 0;
+        }
+        StatFilter filter;
+        if (!setStatFilter(&filter, filterArgs[0], filterArgs[1], filterArgs[2], filterArgs[3],
+                           filterArgs[4], filterArgs[5]))
+        {
+            outPrintf("Invalid choice.\n");
+            return 0;
+        }
+        displayStatMatches(owner, &filter);
+    }
+    else if (strcmp(command, "BYTYPE") == 0 && takeNumber(&rest, &third))
+    {
+        if ((owner = takeOwner(rest, 0, locked)) == NULL)
+        {
+            return 0;
+        }
+        if (owner->pokedexRoot == NULL)
+        {
+            outPrintf("Pokedex is empty.\n");
+            return 0;
+        }
+        displayTypeMatches(owner, third);
+    }
+    else if (strcmp(command, "TOURNAMENT") == 0)
+    {
+        if ((owner = takeOwner(rest, 0, locked)) == NULL)
+        {
+            return 0;
+        }
+        if (owner->pokedexRoot == NULL)
+        {
+            outPrintf("Pokedex is empty.\n");
+            return 0;
+        }
+        pokemonTournament(owner);
+    }
+    else
+    {
+        outPrintf("Unknown command. Send HELP for the list.\n");
+    }
+    return 0;
+}
+
+int executeServerCommand(char *line)
+{
+    char *rest = line;
+    char *command = takeWord(&rest);
+    // commands that add, remove or reorder owners, or need all of them at once
+    int wholeRing = strcmp(command, "NEW") == 0 || strcmp(command, "DELETE") == 0 ||
+                    strcmp(command, "MERGE") == 0 || strcmp(command, "MERGEALL") == 0 ||
+                    strcmp(command, "SORT") == 0 ||
+                    strcmp(command, "SAVE") == 0 || strcmp(command, "LOAD") == 0;
+    if (wholeRing)
+    {
+        pthread_rwlock_wrlock(&ringLock);
+    }
+    else
+    {
+        pthread_rwlock_rdlock(&ringLock);
+    }
+    OwnerNode *locked = NULL;
+    int quit = runServerCommand(command, rest, &locked);
+    if (locked != NULL)
+    {
+        pthread_rwlock_unlock(&locked->lock);
+    }
+    pthread_rwlock_unlock(&ringLock);
+    return quit;
+}
+
+// Make sure the journal holds everything up to byte `target` on disk. Whoever syncs takes all
+// buffered records along, so under load one fsync covers the commands of many workers.
+static void syncServerJournal(uint64_t target)
+{
+    pthread_mutex_lock(&journalSyncLock);
+    if (journal.synced < target)
+    {
+        // take the buffer away; commands running meanwhile start a fresh one
+        pthread_mutex_lock(&journalLock);
+        unsigned char *pending = journal.buf;
+        size_t length = journal.length;
+        uint64_t upTo = journal.sealed;
+        journal.buf = NULL;
+        journal.length = 0;
+        journal.capacity = 0;
+        pthread_mutex_unlock(&journalLock);
+
+        if (writeAll(journal.fd, (const char *)pending, length) != 0 || fsync(journal.fd) != 0)
+        {
+            fprintf(stderr, "Journal write failed.\n");
+        }
+        free(pending);
+        journal.synced = upTo;
+    }
+    pthread_mutex_unlock(&journalSyncLock);
+}
+
+// Next queued client, or NULL once the server is stopping and the queue is empty
+static ServerClient *nextServerJob(void)
+{
+    pthread_mutex_lock(&server.jobLock);
+    while (server.jobHead == NULL && !server.stopping)
+    {
+        pthread_cond_wait(&server.jobReady, &server.jobLock);
+    }
+    ServerClient *client = server.jobHead;
+    if (client != NULL)
+    {
+        server.jobHead = client->nextJob;
+        if (server.jobHead == NULL)
+        {
+            server.jobTail = NULL;
+        }
+        client->nextJob = NULL;
+    }
+    pthread_mutex_unlock(&server.jobLock);
+    return client;
+}
+
+static void *serverWorker(void *unused)
+{
+    (void)unused;
+    // each worker builds whole replies in its own sink
+    OutputSink *sink = (OutputSink *)malloc(sizeof(OutputSink));
+    if (sink == NULL)
+    {
+        return NULL;
+    }
+    sink->fd = -1;
+    sink->collect = 1;
+    sink->collected = NULL;
+    sink->collectedLength = 0;
+    sink->collectedCapacity = 0;
+    sink->overflowed = 0;
+    sink->length = 0;
+    outputSink = sink;
+
+    ServerClient *client;
+    while ((client = nextServerJob()) != NULL)
+    {
+        // a change is on disk before its reply goes out
+        journalSealedHere = 0;
+        client->quit = executeServerCommand(client->command);
+        if (journalSealedHere != 0)
+        {
+            syncServerJournal(journalSealedHere);
+        }
+
+        // a slow reader only holds up this worker, never the owners
+        outFlush();
+        // the end marker goes out even when the reply hit the collect limit
+        const char *end = sink->overflowed ? "Reply too long, cut off.\n.\n" : ".\n";
+        if (writeAll(client->fd, sink->collected, sink->collectedLength) < 0 ||
+            writeAll(client->fd, end, strlen(end)) < 0)
+        {
+            client->failed = 1;
+        }
+        sink->collectedLength = 0;
+        sink->overflowed = 0;
+        free(client->command);
+        client->command = NULL;
+
+        // hand the client back to the event loop (pointer-sized pipe writes are atomic)
+        while (write(server.wakePipe[1], &client, sizeof(client)) < 0 && errno == EINTR)
+        {
+        }
+    }
+    free(sink->collected);
+    free(sink);
+    return NULL;
+}
+
+// Close and free one connection, moving the last one into its slot
+static void dropServerClient(ServerClient *client)
+{
+    int slot = client->slot;
+    server.count--;
+    server.clients[slot] = server.clients[server.count];
+    server.clients[slot]->slot = slot;
+    close(client->fd);
+    free(client->buf);
+    free(client->command);
+    free(client);
+}
+
+// Queue the client's next complete line, if it has one. Returns 0 if the client must be dropped.
+static int dispatchServerClient(ServerClient *client)
+{
+    char *newline = (char *)memchr(client->buf, '\n', client->length);
+    if (newline == NULL)
+    {
+        // no end of line in sight: a runaway line is not buffered forever
+        return client->length < SERVER_LINE_MAX;
+    }
+    size_t lineLength = (size_t)(newline - client->buf);
+    client->command = (char *)malloc(lineLength + 1);
+    if (client->command == NULL)
+    {
+        return 0;
+    }
+    memcpy(client->command, client->buf, lineLength);
+    client->command[lineLength] = '\0';
+    if (lineLength > 0 && client->command[lineLength - 1] == '\r')
+    {
+        client->command[lineLength - 1] = '\0';
+    }
+    client->length -= lineLength + 1;
+    memmove(client->buf, newline + 1, client->length);
+
+    client->busy = 1;
+    pthread_mutex_lock(&server.jobLock);
+    if (server.jobTail == NULL)
+    {
+        server.jobHead = client;
+    }
+    else
+    {
+        server.jobTail->nextJob = client;
+    }
+    server.jobTail = client;
+    pthread_cond_signal(&server.jobReady);
+    pthread_mutex_unlock(&server.jobLock);
+    return 1;
+}
+
+// Take in whatever the client sent. Returns 0 if the client must be dropped.
+static int readServerClient(ServerClient *client)
+{
+    if (client->capacity - client->length < SERVER_LINE_MAX / 4)
+    {
+        size_t capacity = client->capacity ? client->capacity * 2 : SERVER_LINE_MAX / 4;
+        char *grown = (char *)realloc(client->buf, capacity);
+        if (grown == NULL)
+        {
+            return 0;
+        }
+        client->buf = grown;
+        client->capacity = capacity;
+    }
+    ssize_t received = read(client->fd, client->buf + client->length, client->capacity - client->length);
+    if (received < 0 && errno == EINTR)
+    {
+        return 1;
+    }
+    if (received <= 0)
+    {
+        return 0;
+    }
+    client->length += (size_t)received;
+    return dispatchServerClient(client);
+}
+
+// Accept every waiting connection
+static void acceptServerClients(void)
+{
+    while (1)
+    {
+        int fd = accept(server.listenFd, NULL, NULL);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            if ((errno == EMFILE || errno == ENFILE) && server.spareFd >= 0)
+            {
+                // the waiting connection would keep poll waking up at once: free the spare
+                // descriptor, take the connection and close it, then hold the spare again
+                close(server.spareFd);
+                fd = accept(server.listenFd, NULL, NULL);
+                if (fd >= 0)
+                {
+                    close(fd);
+                }
+                server.spareFd = open("/dev/null", O_RDONLY);
+                if (fd < 0)
+                {
+                    return;
+                }
+                continue;
+            }
+            // EAGAIN: nobody else waiting; anything else: try again next round
+            return;
+        }
+        if (server.count == server.capacity)
+        {
+            int capacity = server.capacity ? server.capacity * 2 : 64;
+            ServerClient **clients = (ServerClient **)realloc(server.clients, (size_t)capacity * sizeof(ServerClient *));
+            if (clients != NULL)
+            {
+                server.clients = clients;
+            }
+            struct pollfd *polls = (struct pollfd *)realloc(server.polls, (size_t)(capacity + SERVER_FIXED_POLLS) * sizeof(struct pollfd));
+            if (polls != NULL)
+            {
+                server.polls = polls;
+            }
+            if (clients == NULL || polls == NULL)
+            {
+                close(fd);
+                return;
+            }
+            server.capacity = capacity;
+        }
+        ServerClient *client = (ServerClient *)calloc(1, sizeof(ServerClient));
+        if (client == NULL)
+        {
+            close(fd);
+            return;
+        }
+        // replies are written by blocking workers, but never for longer than this
+        struct timeval timeout = {SERVER_SEND_TIMEOUT_SEC, 0};
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        client->fd = fd;
+        client->slot = server.count;
+        server.clients[server.count++] = client;
     }
+}
 
-    int c;
-    while ((c = getchar()) != '\n' && c != EOF)
+// Clients the workers are done with: drop them or start their next command
+static void collectFinishedClients(void)
+{
+    ServerClient *finished[64];
+    ssize_t received;
+    while ((received = read(server.wakePipe[0], finished, sizeof(finished))) > 0)
     {
-        if (size + 1 >= capacity)
+        for (size_t i = 0; i < (size_t)received / sizeof(ServerClient *); i++)
         {
-            capacity *= 2;
-            char *temp = (char *)realloc(input, capacity);
-            if (!temp)
+            ServerClient *client = finished[i];
+            client->busy = 0;
+            if (client->failed || client->quit || !dispatchServerClient(client))
             {
-                printf("Memory reallocation failed.\n");
-                free(input);
-                return NULL;
+                dropServerClient(client);
             }
-            input = temp;
         }
-        input[size++] = (char)c;
     }
-    input[size] = '\0';
-
-    // Trim any leading/trailing whitespace or carriage returns
-    trimWhitespace(input);
-
-    return input;
 }
 
-// Function to print a single Pokemon node
-void printPokemonNode(PokemonNode *node)
+// Only async-signal-safe work here: the byte in the signal pipe wakes poll even if the signal
+// lands between the loop's flag check and the poll call
+static void onServerSignal(int signal)
 {
-    if (node == NULL) {
-        return;
-    }
-    if (node->data == NULL) {
-        return;
-    }
-    if (node->data->name == NULL) {
-        return;
+    int savedErrno = errno;
+    char byte = (char)signal;
+    serverStopRequested = 1;
+    if (write(server.signalPipe[1], &byte, 1) < 0)
+    {
+        // pipe full: a wake-up is already pending
     }
-    printf("ID: %d, Name: %s, Type: %s, HP: %d, Attack: %d, Can Evolve: %s\n",
-           node->data->id,
-           node->data->name,
-           getTypeName(node->data->TYPE),
-           node->data->hp,
-           node->data->attack,
-           (node->data->CAN_EVOLVE == CAN_EVOLVE) ? "Yes" : "No");
+    errno = savedErrno;
 }
 
-// --------------------------------------------------------------
-// Display Menu
-// --------------------------------------------------------------
-void displayMenu(OwnerNode *owner)
+// Socket, wake and signal pipes, signal handlers. Returns 0 on success.
+static int openServerSocket(const char *socketPath)
 {
-    if (!owner->pokedexRoot || !owner->pokedexRoot->data || !owner->pokedexRoot->data->name)
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path))
     {
-        printf("Pokedex is empty.\n");
-        return;
+        return -1;
     }
+    strcpy(address.sun_path, socketPath);
 
-    printf("Display:\n");
-    printf("1. BFS (Level-Order)\n");
-    printf("2. Pre-Order\n");
-    printf("3. In-Order\n");
-    printf("4. Post-Order\n");
-    printf("5. Alphabetical (by name)\n");
-
-    int choice = readIntSafe("Your choice: ");
-
-    // create function pointer as requirement
-    void (*printFunction)(PokemonNode *root) = printPokemonNode;
+    // a socket left behind by an earlier run is replaced; any other file is not touched
+    struct stat info;
+    if (stat(socketPath, &info) == 0 && S_ISSOCK(info.st_mode))
+    {
+        unlink(socketPath);
+    }
+    server.listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server.listenFd < 0)
+    {
+        return -1;
+    }
+    if (bind(server.listenFd, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+        listen(server.listenFd, SOMAXCONN) != 0 || pipe(server.wakePipe) != 0)
+    {
+        close(server.listenFd);
+        return -1;
+    }
+    if (pipe(server.signalPipe) != 0)
+    {
+        close(server.listenFd);
+        close(server.wakePipe[0]);
+        close(server.wakePipe[1]);
+        return -1;
+    }
+    server.spareFd = open("/dev/null", O_RDONLY);
+    fcntl(server.listenFd, F_SETFL, fcntl(server.listenFd, F_GETFL) | O_NONBLOCK);
+    fcntl(server.wakePipe[0], F_SETFL, fcntl(server.wakePipe[0], F_GETFL) | O_NONBLOCK);
+    // neither end may block: the handler must not stall, and the loop drains until empty
+    fcntl(server.signalPipe[0], F_SETFL, fcntl(server.signalPipe[0], F_GETFL) | O_NONBLOCK);
+    fcntl(server.signalPipe[1], F_SETFL, fcntl(server.signalPipe[1], F_GETFL) | O_NONBLOCK);
 
-    switch (choice)
+    // thousands of clients need thousands of descriptors
+    struct rlimit files;
+    if (getrlimit(RLIMIT_NOFILE, &files) == 0 && files.rlim_cur < files.rlim_max)
     {
-    case DISP_BFS_OPT:
-        displayBFS(owner->pokedexRoot, printFunction);
-        break;
-    case DISP_PRE_ORD_OPT:
-        preOrderTraversal(owner->pokedexRoot, printFunction);
-        break;
-    case DISP_IN_ORD_OPT:
-        inOrderTraversal(owner->pokedexRoot, printFunction);
-        break;
-    case DISP_POST_ORD_OPT:
-        postOrderTraversal(owner->pokedexRoot, printFunction);
-        break;
-    case DISP_ALPH_ORD_OPT:
-        displayAlphabetical(owner->pokedexRoot, printFunction);
-        break;
-    default:
-        printf("Invalid choice.\n");
+        files.rlim_cur = files.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &files);
     }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    sigemptyset(&action.sa_mask);
+    // a client that hangs up mid-reply is a failed write, not the end of the server
+    action.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &action, NULL);
+    // a signal between the loop's flag check and poll still wakes poll through the signal pipe
+    action.sa_handler = onServerSignal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    return 0;
 }
 
-// --------------------------------------------------------------
-// Sub-menu for existing Pokedex
-// --------------------------------------------------------------
-void enterExistingPokedexMenu()
+int runServer(const char *socketPath)
 {
-    // Check if there are any owners
-    if (ownerHead == NULL) {
-        printf("No existing Pokedexes.\n");
-        return;
+    if (openServerSocket(socketPath) != 0)
+    {
+        return -1;
     }
-
-    // list owners
-    printf("\nExisting Pokedexes:\n");
-    // print by looping through each owner - while doesn't equal head, print next etc
-    printAllOwners();
-
-    // get user input for which owner by list number starting at 1
-    int ownerChoice = readIntSafe("Choose a Pokedex by number: ");
-    OwnerNode *cur = ownerHead;
-
-    if (cur==NULL) {
-        printf("No existing Pokedexes.\n");
-        return;
+    // the stop signals must reach this thread's poll, so the workers never take them
+    sigset_t stopSignals;
+    sigset_t previous;
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stopSignals, &previous);
+    int started = 0;
+    while (started < SERVER_WORKERS &&
+           pthread_create(&server.workers[started], NULL, serverWorker, NULL) == 0)
+    {
+        started++;
     }
-
-    // Calculate the number of owners
-    int ownerCount = 1;
-    OwnerNode *temp = ownerHead;
-    while (temp->next != ownerHead) {
-        ownerCount++;
-        temp = temp->next;
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+    if (started == 0)
+    {
+        serverStopRequested = 1;
     }
-
-    // Use modulo to wrap around if ownerChoice exceeds the number of owners
-    ownerChoice = (ownerChoice - 1) % ownerCount + 1;
-
-
-    if (ownerChoice > 1) {
-        for (int i = 1; i < ownerChoice; i++) {
-            cur = cur->next;
-            if (cur == NULL) {
-                printf("Invalid owner choice.\n");
-                return;
-            }
-
+    if (server.polls == NULL)
+    {
+        server.polls = (struct pollfd *)malloc(SERVER_FIXED_POLLS * sizeof(struct pollfd));
+        if (server.polls == NULL)
+        {
+            serverStopRequested = 1;
         }
     }
 
-
-    printf("\nEntering %s's Pokedex...\n", cur->ownerName);
-
-    int subChoice;
-    do
+    while (!serverStopRequested)
     {
-        printf("\n-- %s's Pokedex Menu --\n", cur->ownerName);
-        printf("1. Add Pokemon\n");
-        printf("2. Display Pokedex\n");
-        printf("3. Release Pokemon (by ID)\n");
-        printf("4. Pokemon Fight!\n");
-        printf("5. Evolve Pokemon\n");
-        printf("6. Back to Main\n");
-
-        subChoice = readIntSafe("Your choice: ");
-
-        switch (subChoice)
+        server.polls[0].fd = server.listenFd;
+        server.polls[0].events = POLLIN;
+        server.polls[1].fd = server.wakePipe[0];
+        server.polls[1].events = POLLIN;
+        server.polls[2].fd = server.signalPipe[0];
+        server.polls[2].events = POLLIN;
+        for (int i = 0; i < server.count; i++)
         {
-        case OWN_ADD_OPT:
-            addPokemon(cur);
-            break;
-        case OWN_DISP_OPT:
-            displayMenu(cur);
-            break;
-        case OWN_FREE_OPT:
-            if (!cur->pokedexRoot || !cur->pokedexRoot->data) {
-                printf("No Pokemon to release.\n");
-                break;
-            }
-            freePokemon(cur);
-            // if we removed the only node, name should set to NULL, so check for that here
-            // data is already freed, so just set the pointer to NULL, so we don't later try to reference a freed data point
-            if (cur && cur->pokedexRoot && cur->pokedexRoot->data && cur->pokedexRoot->data->name == NULL) {
-                cur->pokedexRoot = NULL;
-            }
-            // edge case where there is remnant pointer left, this finds it and sets it to null
-            recursivelyCleanNullPokemon(&(cur->pokedexRoot));
-            break;
-        case OWN_FIGHT_OPT:
-            if (cur->pokedexRoot == NULL) {
-                printf("Pokedex is empty.\n");
-                break;
+            // a client with a command in flight is not read until its reply is out
+            server.polls[i + SERVER_FIXED_POLLS].fd = server.clients[i]->busy ? -1 : server.clients[i]->fd;
+            server.polls[i + SERVER_FIXED_POLLS].events = POLLIN;
+            server.polls[i + SERVER_FIXED_POLLS].revents = 0;
+        }
+        int polled = server.count;
+        if (poll(server.polls, (nfds_t)polled + SERVER_FIXED_POLLS, -1) < 0)
+        {
+            continue;
+        }
+        // backwards, so a dropped client's slot is refilled by one already handled
+        for (int i = polled - 1; i >= 0; i--)
+        {
+            if (server.polls[i + SERVER_FIXED_POLLS].revents != 0 && !readServerClient(server.clients[i]))
+            {
+                dropServerClient(server.clients[i]);
             }
-            pokemonFight(cur);
-            break;
-        case OWN_EVOLVE_OPT:
-            if (cur->pokedexRoot == NULL) {
-                printf("Cannot evolve. Pokedex empty.\n");
-                break;
+        }
+        if (server.polls[2].revents != 0)
+        {
+            // the handler already set the flag; the byte was only there to end the poll
+            char drained[16];
+            while (read(server.signalPipe[0], drained, sizeof(drained)) > 0)
+            {
             }
-            evolvePokemon(cur);
-            break;
-        case OWN_BACK_OPT:
-            printf("Back to Main Menu.\n");
-            break;
-        default:
-            printf("Invalid choice.\n");
         }
-    } while (subChoice != 6);
+        if (server.polls[1].revents != 0)
+        {
+            collectFinishedClients();
+        }
+        if (server.polls[0].revents != 0)
+        {
+            acceptServerClients();
+        }
+    }
+
+    // stop taking clients, let the workers finish what is queued
+    close(server.listenFd);
+    unlink(socketPath);
+    pthread_mutex_lock(&server.jobLock);
+    server.stopping = 1;
+    pthread_cond_broadcast(&server.jobReady);
+    pthread_mutex_unlock(&server.jobLock);
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(server.workers[i], NULL);
+    }
+    collectFinishedClients();
+    while (server.count > 0)
+    {
+        dropServerClient(server.clients[0]);
+    }
+    close(server.wakePipe[0]);
+    close(server.wakePipe[1]);
+    // the handler writes to the signal pipe, so it goes before the pipe does
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    sigemptyset(&action.sa_mask);
+    action.sa_handler = SIG_DFL;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    close(server.signalPipe[0]);
+    close(server.signalPipe[1]);
+    if (server.spareFd >= 0)
+    {
+        close(server.spareFd);
+        server.spareFd = -1;
+    }
+    free(server.clients);
+    free(server.polls);
+    server.clients = NULL;
+    server.polls = NULL;
+    server.capacity = 0;
+    return 0;
 }
 
 // --------------------------------------------------------------
@@ -1230,15 +3827,26 @@ void mainMenu()
     int choice;
     do
     {
-        printf("\n=== Main Menu ===\n");
-        printf("1. New Pokedex\n");
-        printf("2. Existing Pokedex\n");
-        printf("3. Delete a Pokedex\n");
-        printf("4. Merge Pokedexes\n");
-        printf("5. Sort Owners by Name\n");
-        printf("6. Print Owners in a direction X times\n");
-        printf("7. Exit\n");
+        if (!batchMode) {
+            outPrintf("\n=== Main Menu ===\n");
+            outPrintf("1. New Pokedex\n");
+            outPrintf("2. Existing Pokedex\n");
+            outPrintf("3. Delete a Pokedex\n");
+            outPrintf("4. Merge Pokedexes\n");
+            outPrintf("5. Sort Owners by Name\n");
+            outPrintf("6. Print Owners in a direction X times\n");
+            outPrintf("7. Exit\n");
+            outPrintf("8. Find owners of a Pokemon\n");
+            outPrintf("9. Rarity report\n");
+            outPrintf("10. Save snapshot\n");
+            outPrintf("11. Load snapshot\n");
+            outPrintf("12. Merge many Pokedexes into one\n");
+        }
         choice = readIntSafe("Your choice: ");
+        // out of input: stop cleanly instead of re-prompting forever
+        if (inputExhausted) {
+            break;
+        }
 
         switch (choice)
         {
@@ -1260,18 +3868,246 @@ void mainMenu()
         case MAIN_PRINT_OPT:
             printOwnersCircular();
             break;
+        case MAIN_FIND_OWNERS_OPT:
+            findOwnersOfPokemon();
+            break;
+        case MAIN_RARITY_OPT:
+            printRarityReport();
+            break;
+        case MAIN_SAVE_OPT:
+            saveSnapshotMenu();
+            break;
+        case MAIN_LOAD_OPT:
+            loadSnapshotMenu();
+            break;
+        case MAIN_BULK_MERGE_OPT:
+            bulkMergePokedexMenu();
+            break;
         case MAIN_EXIT_OPT:
-            printf("Goodbye!\n");
+            outPrintf("Goodbye!\n");
             break;
         default:
-            printf("Invalid.\n");
+            outPrintf("Invalid.\n");
         }
     } while (choice != 7);
 }
 
-int main()
+void printPrompt(const char *text)
+{
+    if (!batchMode)
+    {
+        outString(text);
+    }
+}
+
+// --------------------------------------------------------------
+// Output sink: everything printed is collected here and written in blocks
+// --------------------------------------------------------------
+int writeAll(int fd, const char *text, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = write(fd, text, length);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        text += written;
+        length -= (size_t)written;
+    }
+    return 0;
+}
+
+// Hand text past the block buffer: keep it (collect mode) or write it to the sink's fd
+static void deliverOutput(const char *text, size_t length)
+{
+    if (outputSink->collect)
+    {
+        // one command can't grow a worker's reply without bound
+        if (outputSink->overflowed)
+        {
+            return;
+        }
+        if (length > OUTPUT_COLLECT_MAX - outputSink->collectedLength)
+        {
+            outputSink->overflowed = 1;
+            length = OUTPUT_COLLECT_MAX - outputSink->collectedLength;
+        }
+        if (length > outputSink->collectedCapacity - outputSink->collectedLength)
+        {
+            size_t capacity = outputSink->collectedCapacity ? outputSink->collectedCapacity : OUTPUT_BLOCK_SIZE;
+            while (capacity - outputSink->collectedLength < length)
+            {
+                capacity *= 2;
+            }
+            char *grown = (char *)realloc(outputSink->collected, capacity);
+            if (grown == NULL)
+            {
+                // the reply comes out shorter, better than no reply at all
+                return;
+            }
+            outputSink->collected = grown;
+            outputSink->collectedCapacity = capacity;
+        }
+        memcpy(outputSink->collected + outputSink->collectedLength, text, length);
+        outputSink->collectedLength += length;
+        // a cut reply still ends on a whole line
+        while (outputSink->overflowed && outputSink->collectedLength > 0 &&
+               outputSink->collected[outputSink->collectedLength - 1] != '\n')
+        {
+            outputSink->collectedLength--;
+        }
+    }
+    // a sink without a file descriptor just drops its output
+    else if (outputSink->fd >= 0)
+    {
+        // if nobody is listening any more, the output is dropped
+        writeAll(outputSink->fd, text, length);
+    }
+}
+
+void outFlush(void)
+{
+    if (outputSink->length > 0)
+    {
+        deliverOutput(outputSink->buf, outputSink->length);
+    }
+    outputSink->length = 0;
+}
+
+void outWrite(const char *text, size_t length)
+{
+    if (length > OUTPUT_BLOCK_SIZE - outputSink->length)
+    {
+        outFlush();
+        // too big to be worth copying
+        if (length >= OUTPUT_BLOCK_SIZE)
+        {
+            deliverOutput(text, length);
+            return;
+        }
+    }
+    memcpy(outputSink->buf + outputSink->length, text, length);
+    outputSink->length += length;
+}
+
+void outString(const char *text)
+{
+    outWrite(text, strlen(text));
+}
+
+void outInt(int value)
+{
+    // digits are produced backwards from the end of a small scratch buffer
+    char digits[16];
+    int pos = (int)sizeof(digits);
+    unsigned int magnitude = (value < 0) ? 0u - (unsigned int)value : (unsigned int)value;
+    do
+    {
+        digits[--pos] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0)
+    {
+        digits[--pos] = '-';
+    }
+    outWrite(digits + pos, sizeof(digits) - (size_t)pos);
+}
+
+void outPrintf(const char *format, ...)
+{
+    va_list args;
+    va_list retry;
+    va_start(args, format);
+    va_copy(retry, args);
+    // try formatting straight into the free space
+    size_t room = OUTPUT_BLOCK_SIZE - outputSink->length;
+    int needed = vsnprintf(outputSink->buf + outputSink->length, room, format, args);
+    va_end(args);
+    if (needed < 0)
+    {
+        va_end(retry);
+        return;
+    }
+    if ((size_t)needed < room)
+    {
+        outputSink->length += (size_t)needed;
+        va_end(retry);
+        return;
+    }
+    // did not fit: flush and format again, on the heap if it can never fit
+    outFlush();
+    if ((size_t)needed < OUTPUT_BLOCK_SIZE)
+    {
+        vsnprintf(outputSink->buf, OUTPUT_BLOCK_SIZE, format, retry);
+        outputSink->length = (size_t)needed;
+    }
+    else
+    {
+        char *text = (char *)malloc((size_t)needed + 1);
+        if (text)
+        {
+            vsnprintf(text, (size_t)needed + 1, format, retry);
+            deliverOutput(text, (size_t)needed);
+            free(text);
+        }
+    }
+    va_end(retry);
+}
+
+int main(int argc, char *argv[])
 {
-    mainMenu();
+    const char *journalPath = NULL;
+    const char *socketPath = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], BATCH_MODE_FLAG) == 0)
+        {
+            batchMode = 1;
+        }
+        else if (strcmp(argv[i], JOURNAL_FLAG) == 0 && i + 1 < argc)
+        {
+            journalPath = argv[++i];
+        }
+        else if (strcmp(argv[i], SERVER_FLAG) == 0 && i + 1 < argc)
+        {
+            socketPath = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [%s] [%s <file>] [%s <socket>]\n", argv[0], BATCH_MODE_FLAG,
+                    JOURNAL_FLAG, SERVER_FLAG);
+            return 1;
+        }
+    }
+    initPokedexTables();
+    if (journalPath != NULL && openJournal(journalPath) < 0)
+    {
+        fprintf(stderr, "Could not open journal %s.\n", journalPath);
+        freeAllOwners();
+        return 1;
+    }
+    if (socketPath != NULL)
+    {
+        if (runServer(socketPath) != 0)
+        {
+            fprintf(stderr, "Could not listen on %s.\n", socketPath);
+            closeJournal();
+            freeAllOwners();
+            return 1;
+        }
+    }
+    else
+    {
+        mainMenu();
+    }
+    closeJournal();
     freeAllOwners();
+    releaseInputReader(&stdinReader);
+    outFlush();
     return 0;
 }
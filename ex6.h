@@ -1,10 +1,27 @@
 #ifndef EX6_H
 #define EX6_H
 
+// read(2) and friends are POSIX, not C99
+#define _POSIX_C_SOURCE 200809L
+
 #include <ctype.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 // custom defines to avoid magic numbers and have clearer code
 // display menu options
@@ -13,6 +30,8 @@
 #define DISP_IN_ORD_OPT 3
 #define DISP_POST_ORD_OPT 4
 #define DISP_ALPH_ORD_OPT 5
+#define DISP_STATS_OPT 6
+#define DISP_TYPE_OPT 7
 
 // owner actions menu options
 #define OWN_ADD_OPT 1
@@ -21,6 +40,8 @@
 #define OWN_FIGHT_OPT 4
 #define OWN_EVOLVE_OPT 5
 #define OWN_BACK_OPT 6
+#define OWN_TOURNAMENT_OPT 7
+#define OWN_BULK_ADD_OPT 8
 
 // main menu options
 #define MAIN_OPEN_POKEDEX_OPT 1
@@ -30,6 +51,11 @@
 #define MAIN_SORT_OPT 5
 #define MAIN_PRINT_OPT 6
 #define MAIN_EXIT_OPT 7
+#define MAIN_FIND_OWNERS_OPT 8
+#define MAIN_RARITY_OPT 9
+#define MAIN_SAVE_OPT 10
+#define MAIN_LOAD_OPT 11
+#define MAIN_BULK_MERGE_OPT 12
 
 // starter pokemon options and IDs
 #define BULBASAUR_OPT 1
@@ -41,6 +67,70 @@
 
 #define AMOUNT_OF_POKEMON 151
 
+// 64-bit words in a species bitmask (bit ID - 1 stands for species ID)
+#define SPECIES_MASK_WORDS ((AMOUNT_OF_POKEMON + 63) / 64)
+
+// StatFilter value meaning "don't filter on this field"
+#define FILTER_ANY -1
+
+// owner name hash table: starting bucket count (power of two), grows past 3/4 load
+#define OWNER_REGISTRY_INITIAL_BUCKETS 64
+
+// command-line flag for headless batch mode (no prompts/menus, stop at end of input)
+#define BATCH_MODE_FLAG "--batch"
+
+// bytes fetched from the input file descriptor per read(2); the buffer doubles only for longer lines
+#define INPUT_BLOCK_SIZE 65536
+
+// bytes collected by the output sink before one write(2); also the longest text it formats in place
+#define OUTPUT_BLOCK_SIZE 65536
+
+// most bytes a collecting sink keeps for one reply; anything past it is dropped
+#define OUTPUT_COLLECT_MAX (16 * 1024 * 1024)
+
+// room for one precomputed species display line ("ID: ..., Can Evolve: ...\n")
+#define SPECIES_LINE_SIZE 128
+
+// command-line flag: --journal <path> replays <path> at startup and appends every change to it
+#define JOURNAL_FLAG "--journal"
+
+// snapshot file: 4-byte magic, then format version (bump when the layout changes)
+#define SNAPSHOT_MAGIC "PKDX"
+#define SNAPSHOT_VERSION 1
+
+// command-line flag: --server <socket path> serves clients over a Unix domain socket instead of stdin
+#define SERVER_FLAG "--server"
+
+// threads executing client commands in server mode
+#define SERVER_WORKERS 8
+
+// longest command line a client may send; longer lines close the connection
+#define SERVER_LINE_MAX 4096
+
+// biggest count a client may ask PRINT for; it runs with the owner ring locked
+#define SERVER_MAX_PRINT 10000
+
+// poll slots before the clients: listening socket, wake pipe, signal pipe
+#define SERVER_FIXED_POLLS 3
+
+// seconds a worker waits for a client to take its reply before dropping the client
+#define SERVER_SEND_TIMEOUT_SEC 5
+
+// bulk merge: most threads OR-ing owner masks together, and fewest owners worth giving a thread
+#define BULK_MERGE_THREADS 4
+#define BULK_MERGE_OWNERS_PER_THREAD 256
+
+// owners listed per page when choosing an owner by number
+#define OWNERS_PAGE_SIZE 20
+
+// first slab of an owner's node arena; each next slab doubles (capped so the total fits AMOUNT_OF_POKEMON)
+#define POKEDEX_FIRST_SLAB_NODES 8
+
+// tree shape: 1 = AVL height-balanced Pokedex trees, 0 = plain BST shaped by insertion order
+#ifndef BALANCED_POKEDEX
+#define BALANCED_POKEDEX 1
+#endif
+
 // Attack modifiers
 #define ATTACK_MODIFIER 1.5
 #define HP_MODIFIER 1.2
@@ -64,6 +154,9 @@ typedef enum
     ICE
 } PokemonType;
 
+// number of PokemonType values (GRASS..ICE)
+#define POKEMON_TYPE_COUNT 15
+
 typedef enum
 {
     CANNOT_EVOLVE,
@@ -83,46 +176,242 @@ typedef struct PokemonData
 // Binary Tree Node (for Pokédex)
 typedef struct PokemonNode
 {
-    PokemonData *data;
+    const PokemonData *data;  // shared, read-only entry of the global pokedex[] catalog
     struct PokemonNode *left;
     struct PokemonNode *right;
+    int height;               // height of the subtree rooted here (leaf = 1), used for balancing
 } PokemonNode;
 
+// Set of species: bit (ID - 1) of words[] is set when species ID is in the set
+typedef struct SpeciesMask
+{
+    uint64_t words[SPECIES_MASK_WORDS];
+} SpeciesMask;
+
+// Catalog stats as parallel columns (index = ID - 1), so a filter scans only the fields it tests
+typedef struct PokedexColumns
+{
+    int hp[AMOUNT_OF_POKEMON];
+    int attack[AMOUNT_OF_POKEMON];
+    int type[AMOUNT_OF_POKEMON];      // PokemonType
+    int canEvolve[AMOUNT_OF_POKEMON]; // EvolutionStatus
+} PokedexColumns;
+
+// Stat predicate for filterSpecies: all conditions must hold, bounds are inclusive
+typedef struct StatFilter
+{
+    int minHP;
+    int maxHP;
+    int minAttack;
+    int maxAttack;
+    int type;      // PokemonType, or FILTER_ANY
+    int canEvolve; // EvolutionStatus, or FILTER_ANY
+} StatFilter;
+
+// One contiguous chunk of PokemonNodes inside an owner's arena
+typedef struct PokedexSlab
+{
+    struct PokedexSlab *next; // older slab
+    int capacity;             // nodes in this slab
+    int used;                 // nodes handed out so far (bump pointer)
+    PokemonNode nodes[];      // the nodes themselves
+} PokedexSlab;
+
+// Per-owner node allocator: slabs + free list of released nodes
+typedef struct PokedexArena
+{
+    PokedexSlab *slabs;     // newest slab first
+    int totalCapacity;      // nodes across all slabs
+    PokemonNode *freeList;  // released nodes, chained through their left pointer
+} PokedexArena;
+
 // Linked List Node (for Owners)
 typedef struct OwnerNode
 {
     char *ownerName;          // Owner's name
     PokemonNode *pokedexRoot; // Pointer to the root of the owner's Pokédex
+    PokemonNode *pokemonByID[AMOUNT_OF_POKEMON + 1]; // Direct-address index: ID -> node in the Pokédex (NULL if not owned)
+    PokedexArena arena;       // Storage for every node of this owner's Pokédex
+    SpeciesMask heldMask;     // Species in the Pokédex (same set as the non-NULL pokemonByID entries)
+    SpeciesMask typeMasks[POKEMON_TYPE_COUNT]; // heldMask split by PokemonType
+    int holderSlot[AMOUNT_OF_POKEMON + 1]; // For each held ID: index of this owner in speciesHolders[ID] (-1 if missing)
     struct OwnerNode *next;   // Next owner in the linked list
     struct OwnerNode *prev;   // Previous owner in the linked list
+    unsigned int nameHash;    // Hash of ownerName, cached for the registry
+    struct OwnerNode *hashNext; // Next owner in the same registry bucket
+    int position;             // Index in the owner directory (list number - 1)
+    pthread_rwlock_t lock;    // Server mode: shared to read this Pokedex, exclusive to change it
 } OwnerNode;
 
 // Global head pointer for the linked list of owners
 OwnerNode *ownerHead = NULL;
 
-// Queue node for BFS printing
-typedef struct PokedexQueueNode {
-   PokemonNode *data;
-   struct PokedexQueueNode *next;
-} PokedexQueueNode;
+// 1 when started with BATCH_MODE_FLAG: prompts and menus are not printed
+int batchMode = 0;
 
-// Queue for BFS printing
-typedef struct PokedexQueue {
-   PokedexQueueNode *front;
-   PokedexQueueNode *rear;
-} PokedexQueue;
+// Set once stdin has no more input; menus and operations stop instead of re-prompting
+int inputExhausted = 0;
 
-// Queue node for BFS printing
-typedef struct IDQueueNode {
-   int data;
-   struct IDQueueNode *next;
-} IDQueueNode;
+// Block-buffered line reader over a file descriptor: lines are handed out as views into buf
+typedef struct InputReader
+{
+    int fd;          // where the bytes come from
+    char *buf;       // block buffer (allocated on first read)
+    size_t capacity; // size of buf
+    size_t start;    // first byte not yet handed out
+    size_t end;      // one past the last byte read
+    int eof;         // fd reported end of input (or an error)
+} InputReader;
+
+// The shared reader for stdin, used by getDynamicInput and readIntSafe
+InputReader stdinReader = {STDIN_FILENO, NULL, 0, 0, 0, 0};
+
+// Buffered writer over a file descriptor: output is collected and sent in big blocks
+typedef struct OutputSink
+{
+    int fd;                      // where the bytes go (-1: dropped)
+    int collect;                 // 1: flushed bytes pile up in collected instead of going to fd
+    char *collected;             // whole reply so far (collect mode)
+    size_t collectedLength;      // bytes in collected
+    size_t collectedCapacity;    // size of collected
+    int overflowed;              // collect mode: output past OUTPUT_COLLECT_MAX was dropped
+    size_t length;               // bytes waiting in buf
+    char buf[OUTPUT_BLOCK_SIZE]; // pending output
+} OutputSink;
+
+// The sink for stdout
+OutputSink stdoutSink = {STDOUT_FILENO, 0, NULL, 0, 0, 0, 0, {0}};
+
+// Where all program output goes (outPrintf, outWrite, ...); each server worker points it at its own sink
+__thread OutputSink *outputSink = &stdoutSink;
+
+// Record types of the mutation journal
+typedef enum
+{
+    JOURNAL_OPEN = 1, // new owner: u32 starter ID, name
+    JOURNAL_ADD,      // u32 owner position, u32 ID
+    JOURNAL_RELEASE,  // u32 owner position, u32 ID
+    JOURNAL_EVOLVE,   // u32 owner position, u32 ID
+    JOURNAL_MERGE,    // u32 target position, u32 source position
+    JOURNAL_DELETE,   // u32 owner position
+    JOURNAL_SORT,     // no payload
+    JOURNAL_RESET,    // all owners dropped (snapshot load), no payload
+    JOURNAL_OWNER,    // owner with a whole Pokedex: SPECIES_MASK_WORDS x u64 mask, name
+    JOURNAL_BULK_MERGE, // u32 target position, then one u32 position per source
+    JOURNAL_BULK_ADD  // u32 owner position, SPECIES_MASK_WORDS x u64 mask of the IDs added
+} JournalOp;
+
+// Append-only log of every mutation. Records are framed as
+// u32 payload length | u8 op | payload | u32 FNV-1a of op + payload (little-endian)
+typedef struct Journal
+{
+    int fd;             // open journal file, -1 when journaling is off
+    unsigned char *buf; // records not yet written (group commit)
+    size_t length;      // bytes waiting in buf
+    size_t capacity;    // size of buf
+    int replaying;      // 1 while replaying: ops must not log themselves again
+    uint64_t sealed;    // bytes of records ever added to buf
+    uint64_t synced;    // of those, bytes known to be on disk (server mode)
+} Journal;
+
+Journal journal = {-1, NULL, 0, 0, 0, 0, 0};
+
+// One connection in server mode
+typedef struct ServerClient
+{
+    int fd;                        // connected socket
+    int slot;                      // index in server.clients
+    char *buf;                     // bytes received, not yet taken as commands
+    size_t length;                 // bytes in buf
+    size_t capacity;               // size of buf
+    char *command;                 // line being executed (one per client at a time)
+    int busy;                      // a worker owns the client until it reports back
+    int quit;                      // client asked to end the session
+    int failed;                    // the reply could not be delivered
+    struct ServerClient *nextJob;  // next client in the job queue
+} ServerClient;
+
+// Server mode: the event loop's connections and the queue feeding the workers
+typedef struct Server
+{
+    int listenFd;                  // listening socket (nonblocking)
+    int wakePipe[2];               // workers write finished ServerClient pointers to [1]
+    int signalPipe[2];             // the stop-signal handler writes a byte to [1]
+    int spareFd;                   // held back so a client can be turned away when descriptors run out
+    ServerClient **clients;        // open connections
+    struct pollfd *polls;          // listenFd, wakePipe[0], signalPipe[0], then one per client
+    int count;                     // open connections
+    int capacity;                  // allocated slots in clients / polls
+    ServerClient *jobHead;         // commands waiting for a worker (FIFO)
+    ServerClient *jobTail;
+    pthread_mutex_t jobLock;       // guards the job queue and stopping
+    pthread_cond_t jobReady;       // signalled when a job is queued or on shutdown
+    int stopping;                  // workers exit once the queue is empty
+    pthread_t workers[SERVER_WORKERS];
+} Server;
+
+Server server = {-1, {-1, -1}, {-1, -1}, -1, NULL, NULL, 0, 0, NULL, NULL,
+                 PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, {0}};
+
+// Server-mode locking, always taken in this order: ringLock, one OwnerNode::lock, then the short
+// holdersLock / journalLock. Every command holds ringLock shared; adding, removing or reordering
+// owners (and save / load, which need every owner at once) hold it exclusively.
+pthread_rwlock_t ringLock = PTHREAD_RWLOCK_INITIALIZER;
+
+// Guards speciesHolders and every owner's holderSlot (owners changed in parallel share them)
+pthread_mutex_t holdersLock = PTHREAD_MUTEX_INITIALIZER;
+
+// Guards the journal buffer and journal.sealed
+pthread_mutex_t journalLock = PTHREAD_MUTEX_INITIALIZER;
+
+// Serializes server-mode journal syncs; taken before journalLock, never while holding it
+pthread_mutex_t journalSyncLock = PTHREAD_MUTEX_INITIALIZER;
+
+// journal.sealed right after this thread's last record
+__thread uint64_t journalSealedHere = 0;
+
+// Set by SIGINT / SIGTERM to end the server loop
+volatile sig_atomic_t serverStopRequested = 0;
+
+// Hash index of all owners by name (chained through OwnerNode::hashNext)
+typedef struct OwnerRegistry
+{
+    OwnerNode **buckets; // bucketCount chains
+    int bucketCount;     // always a power of two (0 before first use)
+    int size;            // owners registered
+} OwnerRegistry;
+
+// Global name -> owner index, kept in sync with the circular list
+OwnerRegistry ownerRegistry = {NULL, 0, 0};
+
+// Owners in ring order starting at ownerHead: owners[i] has list number i + 1
+typedef struct OwnerDirectory
+{
+    OwnerNode **owners; // position -> owner
+    int count;          // number of owners (maintained incrementally)
+    int capacity;       // allocated slots
+} OwnerDirectory;
 
-// Queue for BFS printing
-typedef struct IDQueue {
-   IDQueueNode *front;
-   IDQueueNode *rear;
-} IDQueue;
+// Global list number -> owner index, kept in sync with the circular list
+OwnerDirectory ownerDirectory = {NULL, 0, 0};
+
+// Owners holding one species, in no particular order (removal swaps the last one in)
+typedef struct SpeciesHolders
+{
+    OwnerNode **owners; // count owners, each with owners[i]->holderSlot[ID] == i
+    int count;
+    int capacity;
+} SpeciesHolders;
+
+// Global inverted index ID -> owners holding it (index 0 unused), kept in sync by markSpeciesHeld/Released
+SpeciesHolders speciesHolders[AMOUNT_OF_POKEMON + 1];
+
+// Ring-buffer queue of nodes for level-order work: fixed array, no allocation per node
+typedef struct PokemonQueue {
+   PokemonNode *items[AMOUNT_OF_POKEMON]; // a Pokedex never holds more nodes than this
+   int front;                             // index of the next node to pop
+   int count;                             // nodes waiting
+} PokemonQueue;
 
 
 /* ------------------------------------------------------------
@@ -136,6 +425,77 @@ typedef struct IDQueue {
  */
 void trimWhitespace(char *str);
 
+/**
+ * @brief Hand out the next line of input as a view into the reader's buffer.
+ * @param reader the input layer to read from
+ * @param length out: length of the line, without the '\n'
+ * @return NUL-terminated line (valid until the next call), or NULL at end of input
+ * Why we made it: One big read(2) per block instead of one getchar per byte.
+ */
+char *readInputLine(InputReader *reader, size_t *length);
+
+/**
+ * @brief Narrow a line view past leading/trailing spaces, tabs and '\r'.
+ * @param line start of the view (moved forward)
+ * @param length length of the view (shrunk)
+ * Why we made it: Trimming a view needs no copying.
+ */
+void trimLineView(char **line, size_t *length);
+
+/**
+ * @brief Free the reader's buffer.
+ * @param reader the input layer to release
+ */
+void releaseInputReader(InputReader *reader);
+
+/**
+ * @brief printf into the output sink.
+ * @param format printf-style format
+ * Why we made it: All output shares one buffer, so it leaves in a few big writes and stays in order.
+ */
+void outPrintf(const char *format, ...);
+
+/**
+ * @brief Append raw bytes to the output sink.
+ * @param text bytes to append
+ * @param length how many
+ */
+void outWrite(const char *text, size_t length);
+
+/**
+ * @brief write(2) all bytes, retrying short and interrupted writes.
+ * @param fd destination
+ * @param text bytes to write
+ * @param length how many
+ * @return 0 on success, -1 on error
+ */
+int writeAll(int fd, const char *text, size_t length);
+
+/**
+ * @brief Append a NUL-terminated string to the output sink.
+ * @param text string to append
+ */
+void outString(const char *text);
+
+/**
+ * @brief Append a decimal integer to the output sink, without printf.
+ * @param value number to append
+ * Why we made it: Listings print a number per line; formatting it by hand is much cheaper.
+ */
+void outInt(int value);
+
+/**
+ * @brief Write everything pending in the output sink.
+ * Why we made it: Called before blocking on input and at exit, so prompts and results show up on time.
+ */
+void outFlush(void);
+
+/**
+ * @brief Fill the per-species lookup tables from pokedex[].
+ * Why we made it: Everything derived from the (constant) catalog is computed once at startup.
+ */
+void initPokedexTables(void);
+
 /**
  * @brief C99-friendly strdup replacement.
  * @param src source string
@@ -146,12 +506,19 @@ char *myStrdup(const char *src);
 
 /**
  * @brief Read an integer safely, re-prompt if invalid.
- * @param prompt text to display
- * @return valid integer from user
+ * @param prompt text to display (skipped in batch mode)
+ * @return valid integer from user, or 0 with inputExhausted set at end of input
  * Why we made it: We want robust menu/ID input handling.
  */
 int readIntSafe(const char *prompt);
 
+/**
+ * @brief Print a prompt or menu text, unless running in batch mode.
+ * @param text text to print as-is
+ * Why we made it: Scripted runs only want operation results.
+ */
+void printPrompt(const char *text);
+
 /**
  * @brief Read a line from stdin, store in malloc'd buffer, trim whitespace.
  * @return pointer to the newly allocated string (caller frees)
@@ -172,29 +539,38 @@ const char *getTypeName(PokemonType type);
    ------------------------------------------------------------ */
 
 /**
- * @brief Create a BST node with a copy of the given PokemonData.
- * @param data pointer to PokemonData (like from the global pokedex)
- * @return newly allocated PokemonNode*
- * Why we made it: We need a standard way to allocate BST nodes.
+ * @brief Take a node from an arena (free list first, then the newest slab, then a new slab).
+ * @param arena the owner's arena
+ * @param data pointer to PokemonData from the global pokedex
+ * @return node with no children, or NULL if a new slab couldn't be allocated
+ * Why we made it: Owner trees live in contiguous slabs instead of one malloc per node.
+ */
+PokemonNode *allocArenaNode(PokedexArena *arena, const PokemonData *data);
+
+/**
+ * @brief Give a node back to its arena's free list.
+ * @param arena the owner's arena
+ * @param node node that came from this arena (already unlinked from the tree)
+ * Why we made it: Released Pokemon slots get reused by the next add.
  */
-PokemonNode *createPokemonNode(const PokemonData *data);
+void freeArenaNode(PokedexArena *arena, PokemonNode *node);
+
+/**
+ * @brief Free every slab of an arena at once, dropping all of its nodes.
+ * @param arena the owner's arena
+ * Why we made it: Dropping a whole Pokedex frees a handful of slabs, not every node.
+ */
+void releaseArena(PokedexArena *arena);
 
 /**
  * @brief Create an OwnerNode for the circular owners list.
  * @param ownerName the dynamically allocated name
- * @param starter BST root for the starter Pokemon
+ * @param starterID ID of the starter Pokemon (0 for an empty Pokedex)
  * @return newly allocated OwnerNode*
  * Why we made it: Each user is represented as an OwnerNode.
  */
-OwnerNode *createOwner(char *ownerName, PokemonNode *starter);
+OwnerNode *createOwner(char *ownerName, int starterID);
 
-/**
- * @brief Free one PokemonNode (including name).
- * @param pokemonInTree pointer to pointer to node tree
- * @param IDToRelease ID of pokemon we want to release
- * Why we made it: Avoid memory leaks for single nodes.
- */
-void freePokemonNode(PokemonNode **pokemonInTree, int IDToRelease);
 /**
  * @brief Recursively free a BST of PokemonNodes.
  * @param root BST root
@@ -209,79 +585,102 @@ void freePokemonTree(PokemonNode *root);
  */
 void freeOwnerNode(OwnerNode *owner);
 
-/**
- * @brief Recursively free all PokemonNodes from a given root (can be sub-tree).
- * Why we made it: Useful for cleaning tree for end of program or for restructure.
- */
-void recursivelyFreePokemonNodes(PokemonNode *root);
-
 /* ------------------------------------------------------------
    3) BST Insert, Search, Remove
    ------------------------------------------------------------ */
 
 /**
- * @brief Insert a PokemonNode into BST by ID; duplicates freed.
- * @param root pointer to pointer to BST root
- * @param newNode node to insert
- * @return updated BST root
+ * @brief Insert a PokemonNode into the tree by ID, rebalancing on the way back up.
+ * @param root pointer to pointer to the tree root (updated in place)
+ * @param newNode node to insert; on a duplicate ID the tree is left unchanged and the caller keeps the node
  * Why we made it: Standard BST insertion ignoring duplicates.
  */
 void insertPokemonNode(PokemonNode **root, PokemonNode *newNode);
 
 /**
- * @brief BFS search for a Pokemon by ID in the BST.
- * @param root BST root
- * @param id ID to find
- * @return pointer to found node or NULL
- * Why we made it: BFS ensures we find nodes even in an unbalanced tree.
+ * @brief Unlink the node with the given ID from a BST without freeing it.
+ * @param root pointer to pointer to BST root
+ * @param id ID to unlink
+ * @return the unlinked node (children cleared) or NULL if not found
+ * Why we made it: O(height) in-place removal; the in-order successor node is spliced into
+ *                 the hole, so no node changes its data and nothing is allocated.
  */
-PokemonNode *searchPokemonBFS(PokemonNode *root, int id);
+PokemonNode *unlinkPokemonNode(PokemonNode **root, int id);
 
 /**
- * @brief Remove node from BST by ID if found (BST removal logic).
- * @param root BST root
- * @param id ID to remove
- * @return updated BST root
- * Why we made it: We handle special cases of a BST remove (0,1,2 children).
+ * @brief Height of a subtree (0 for NULL).
+ * @param node subtree root
+ * @return stored height of the node
+ * Why we made it: Balancing decisions need O(1) subtree heights.
  */
-PokemonNode *removeNodeBST(PokemonNode *root, int id);
+int getNodeHeight(PokemonNode *node);
 
 /**
- * @brief Combine BFS search + BST removal to remove Pokemon by ID.
- * @param root BST root
- * @param id the ID to remove
- * @return updated BST root
- * Why we made it: BFS confirms existence, then removeNodeBST does the removal.
+ * @brief Recompute a node's height from its children.
+ * @param node subtree root
+ * Why we made it: Every structural change must keep heights up to date.
+ */
+void updateNodeHeight(PokemonNode *node);
+
+/**
+ * @brief Rotate a subtree left (right child becomes the new root).
+ * @param root subtree root
+ * @return new subtree root
+ * Why we made it: Basic AVL rotation.
+ */
+PokemonNode *rotateLeft(PokemonNode *root);
+
+/**
+ * @brief Rotate a subtree right (left child becomes the new root).
+ * @param root subtree root
+ * @return new subtree root
+ * Why we made it: Basic AVL rotation.
+ */
+PokemonNode *rotateRight(PokemonNode *root);
+
+/**
+ * @brief Fix the height of a node and, in balanced mode, rotate it back into AVL shape.
+ * @param root subtree root whose children are already balanced
+ * @return new subtree root
+ * Why we made it: Called on the way back up from every insert/remove so trees stay O(log n) tall.
  */
-PokemonNode *removePokemonByID(PokemonNode *root, int id);
+PokemonNode *rebalanceNode(PokemonNode *root);
 
 /**
- * @brief Add a Pokemon to the BST by ID, avoiding duplicates.
+ * @brief Collect a BST's nodes in in-order (ascending ID) into an array.
  * @param root BST root
- * @param ID ID to add
- * @return 1 if added, 0 if already present
- * Why we made it: Simplifies adding a Pokemon to a BST.
+ * @param nodes output array, large enough for every node (AMOUNT_OF_POKEMON is always enough)
+ * @param count pointer to number of nodes written so far (incremented)
+ * Why we made it: Sorted node sequences let us merge/rebuild trees in linear time.
  */
-int addPKMNToBST(PokemonNode *root, int ID);
+void collectInOrder(PokemonNode *root, PokemonNode **nodes, int *count);
 
 /**
- * @brief Recursively clean all NULL PokemonNode pointers from a BST.
- * @param root pointer to pointer to BST root
- * Why we made it: Avoid memory leaks from freeing NULL nodes.
+ * @brief Relink an ascending array of nodes into a height-balanced BST.
+ * @param nodes nodes sorted by ID
+ * @param count number of nodes
+ * @return root of the rebuilt tree (NULL if count is 0)
+ * Why we made it: Linear-time rebuild after merges, no allocations.
  */
-void recursivelyCleanNullPokemon(PokemonNode **root);
+PokemonNode *buildBalancedTree(PokemonNode **nodes, int count);
+
+/**
+ * @brief Union two ascending node sequences into one; duplicates from the second are skipped.
+ * @param first nodes sorted by ID (kept on ties)
+ * @param firstCount number of nodes in first
+ * @param second nodes sorted by ID (skipped on ties)
+ * @param secondCount number of nodes in second
+ * @param merged output array with room for firstCount + secondCount nodes
+ * @return number of nodes written to merged
+ * Why we made it: One linear pass instead of an insertion per node.
+ */
+int mergeSortedPokemonNodes(PokemonNode **first, int firstCount, PokemonNode **second, int secondCount,
+                            PokemonNode **merged);
 
 /* ------------------------------------------------------------
    4) Generic BST Traversals (Function Pointers)
    ------------------------------------------------------------ */
 
-/**
- * @brief Create a copy of the PokemonData from the Pokedex Array
- * @param id Pokedex Pokemon ID
- * @return pointer to a copy of the PokemonData
- */
-PokemonData *copyPokedexEntryByID(int id);
-
 // Please notice, it's not really generic, it's just a demonstration of function pointers.
 // so don't be confused by the name, but please remember that you must use it.
 
@@ -296,12 +695,26 @@ typedef void (*VisitNodeFunc)(PokemonNode *);
 void BFSGeneric(PokemonNode *root, VisitNodeFunc visit);
 
 /**
- * @brief Create a new queue node for BFS traversal.
- * @param data pointer to PokemonNode
- * @return newly allocated PokedexQueueNode
- * Why we made it: We need a standard way to allocate queue nodes.
+ * @brief Empty a queue so it can be (re)used.
+ * @param queue the queue
+ */
+void initPokemonQueue(PokemonQueue *queue);
+
+/**
+ * @brief Add a node at the back of the queue.
+ * @param queue the queue
+ * @param node node to add
+ * @return 1 on success, 0 if the queue is full
+ * Why we made it: BFS enqueues every node; wrapping around an array costs no malloc.
+ */
+int pushPokemonQueue(PokemonQueue *queue, PokemonNode *node);
+
+/**
+ * @brief Take the node at the front of the queue.
+ * @param queue the queue
+ * @return the node, or NULL if the queue is empty
  */
-PokedexQueueNode *createQueueNode(PokemonNode *data);
+PokemonNode *popPokemonQueue(PokemonQueue *queue);
 
 /**
  * @brief A generic pre-order traversal (Root-Left-Right).
@@ -338,50 +751,19 @@ void printPokemonNode(PokemonNode *node);
    5) Display Methods (BFS, Pre, In, Post, Alphabetical)
    ------------------------------------------------------------ */
 
-typedef struct
-{
-    PokemonNode **nodes;
-    int size;
-    int capacity;
-} NodeArray;
-
-/**
- * @brief Count the number of nodes in a BST.
- * @param root BST root
- * @return number of nodes
- * Why we made it: Useful for pre-allocating an array for sorting.
- */
-int countNodesInTree(PokemonNode *root);
-
 /**
- * @brief Initialize a NodeArray with given capacity.
- * @param na pointer to NodeArray
- * @param cap initial capacity
- * Why we made it: We store pointers to PokemonNodes for alphabetical sorting.
+ * @brief Compare function for qsort (alphabetical by pokedex[] name).
+ * @param a pointer to an int index into pokedex[]
+ * @param b pointer to an int index into pokedex[]
+ * @return <0, 0, or >0 like strcmp
+ * Why we made it: Ranking the catalog by name once at startup.
  */
-void initNodeArray(NodeArray *na, int cap);
+int compareSpeciesByName(const void *a, const void *b);
 
 /**
- * @brief Recursively collect all nodes from the BST into a NodeArray.
+ * @brief Alphabetical display: drop every node into its species' name-rank slot, then print the slots in order.
  * @param root BST root
- * @param na pointer to NodeArray
- * Why we made it: We gather everything for qsort.
- */
-void collectAll(PokemonNode *root, NodeArray *na);
-
-/**
- * @brief Compare function for qsort (alphabetical by node->data->name).
- * @param a pointer to a pointer to PokemonNode
- * @param b pointer to a pointer to PokemonNode
- * @return -1, 0, or +1
- * Why we made it: Sorting by name for alphabetical display.
- */
-int compareByNameNode(const void *a, const void *b);
-
-/**
- * @brief BFS is nice, but alphabetical means we gather all nodes, sort by name, then print.
- * @param root BST root
- * Why we made it: Provide user the option to see Pokemon sorted by name.
+ * Why we made it: Provide user the option to see Pokemon sorted by name, without sorting or comparing names.
  */
 void displayAlphabetical(PokemonNode *root, VisitNodeFunc visit);
 
@@ -413,6 +795,124 @@ void inOrderTraversal(PokemonNode *root, VisitNodeFunc visit);
  */
 void postOrderTraversal(PokemonNode *root, VisitNodeFunc visit);
 
+/**
+ * @brief Ask for HP and Attack bounds, a type and evolvability, print the owner's Pokemon matching all (ID order).
+ * @param owner pointer to the Owner
+ * Why we made it: Stat queries answered from the catalog columns and the owner's mask, no tree walk.
+ */
+void displayByStats(OwnerNode *owner);
+
+/**
+ * @brief Print the owner's Pokemon matching every predicate of the filter (ID order).
+ * @param owner pointer to the Owner
+ * @param filter predicates, e.g. from setStatFilter
+ */
+void displayStatMatches(OwnerNode *owner, const StatFilter *filter);
+
+/**
+ * @brief Visit the owner's node of every species in the mask, in ID order.
+ * @param owner pointer to the Owner
+ * @param mask species to visit (must all be held by the owner)
+ * @param visit function pointer
+ * Why we made it: Filtered displays jump straight to the matching nodes.
+ */
+void visitSpeciesMask(OwnerNode *owner, const SpeciesMask *mask, VisitNodeFunc visit);
+
+/**
+ * @brief Ask for a type, print the owner's Pokemon of that type (ID order).
+ * @param owner pointer to the Owner
+ * Why we made it: The owner's type mask says exactly which nodes to print, nothing else is touched.
+ */
+void displayByType(OwnerNode *owner);
+
+/**
+ * @brief Print the owner's Pokemon of one type (ID order).
+ * @param owner pointer to the Owner
+ * @param choice type number as listed by displayByType (1-based)
+ */
+void displayTypeMatches(OwnerNode *owner, int choice);
+
+/* ------------------------------------------------------------
+   Species masks and stat filters
+   ------------------------------------------------------------ */
+
+/**
+ * @brief Add / remove / test one species in a mask.
+ * @param mask the mask
+ * @param id species ID (1..AMOUNT_OF_POKEMON)
+ */
+void setSpeciesBit(SpeciesMask *mask, int id);
+void clearSpeciesBit(SpeciesMask *mask, int id);
+int hasSpeciesBit(const SpeciesMask *mask, int id);
+
+/**
+ * @brief Record that the owner now holds / no longer holds a species (heldMask and typeMasks).
+ * @param owner pointer to the Owner
+ * @param id species ID
+ * Why we made it: Every place that changes pokemonByID keeps the masks in step through these.
+ */
+void markSpeciesHeld(OwnerNode *owner, int id);
+void markSpeciesReleased(OwnerNode *owner, int id);
+
+/**
+ * @brief Empty heldMask and every type mask of an owner.
+ * @param owner pointer to the Owner
+ */
+void clearOwnerMasks(OwnerNode *owner);
+
+/**
+ * @brief result = a AND b, word by word.
+ * @param a first mask
+ * @param b second mask
+ * @param result output (may be a or b)
+ * Why we made it: Filter results are intersected with what an owner holds.
+ */
+void intersectSpeciesMasks(const SpeciesMask *a, const SpeciesMask *b, SpeciesMask *result);
+
+/**
+ * @brief Number of species in a mask.
+ * @param mask the mask
+ * @return how many bits are set
+ */
+int countSpeciesMask(const SpeciesMask *mask);
+
+/**
+ * @brief Start a filter that matches every species.
+ * @param filter filter to reset
+ */
+void initStatFilter(StatFilter *filter);
+
+/**
+ * @brief Fill a filter from menu-style numbers.
+ * @param filter filter to set
+ * @param minHP minimum HP
+ * @param maxHP maximum HP, 0 for no limit
+ * @param minAttack minimum Attack
+ * @param maxAttack maximum Attack, 0 for no limit
+ * @param typeChoice 1-15 as in the type menu, 0 for any type
+ * @param evolveChoice 1 can evolve, 2 can't, 0 either
+ * @return 1 if set, 0 if typeChoice or evolveChoice is out of range
+ * Why we made it: The display menu and the server FILTER command read the same numbers.
+ */
+int setStatFilter(StatFilter *filter, int minHP, int maxHP, int minAttack, int maxAttack,
+                  int typeChoice, int evolveChoice);
+
+/**
+ * @brief Every species of the catalog matching all predicates of the filter.
+ * @param filter predicates (inclusive bounds, FILTER_ANY for type/canEvolve to skip them)
+ * @param result output mask
+ * Why we made it: Branch-free scans over the pokedexColumns arrays vectorize; the mask combines cheaply with others.
+ */
+void filterSpecies(const StatFilter *filter, SpeciesMask *result);
+
+/**
+ * @brief Parse a list of IDs and ID ranges ("1-10,25 30") into a mask.
+ * @param text list to parse (commas and/or spaces between items)
+ * @param result output mask (repeats collapse into one bit)
+ * @return number of distinct IDs, or -1 if an item isn't an ID or range of IDs
+ */
+int parseSpeciesList(const char *text, SpeciesMask *result);
+
 /* ------------------------------------------------------------
    6) Pokemon-Specific
    ------------------------------------------------------------ */
@@ -424,6 +924,32 @@ void postOrderTraversal(PokemonNode *root, VisitNodeFunc visit);
  */
 void pokemonFight(OwnerNode *owner);
 
+/**
+ * @brief Fight two Pokemon of the owner, given by ID.
+ * @param owner pointer to the Owner
+ * @param ID1 first fighter
+ * @param ID2 second fighter
+ * Why we made it: The fight itself, shared by the menu and the server.
+ */
+void fightPokemonByID(OwnerNode *owner, int ID1, int ID2);
+
+/**
+ * @brief Count, for every score, how many of the scores beat it and how many tie with it.
+ * @param scores fight scores, one per Pokemon
+ * @param count number of scores
+ * @param wins out: wins[i] = how many scores[j] are lower than scores[i]
+ * @param ties out: ties[i] = how many other scores[j] equal scores[i]
+ * Why we made it: Branch-free inner loops over a plain float array, so the compiler can vectorize the round robin.
+ */
+void tallyRoundRobin(const float *scores, int count, int *wins, int *ties);
+
+/**
+ * @brief Every Pokemon in the Pokedex fights every other one; print the standings.
+ * @param owner pointer to the Owner
+ * Why we made it: One command instead of a fight menu round trip per pair.
+ */
+void pokemonTournament(OwnerNode *owner);
+
 /**
  * @brief Evolve a Pokemon (ID -> ID+1) if allowed.
  * @param owner pointer to the Owner
@@ -431,6 +957,13 @@ void pokemonFight(OwnerNode *owner);
  */
 void evolvePokemon(OwnerNode *owner);
 
+/**
+ * @brief Evolve one Pokemon of the owner, given by ID, and report the result.
+ * @param owner pointer to the Owner
+ * @param IDToEvolve ID to evolve
+ */
+void evolvePokemonByID(OwnerNode *owner, int IDToEvolve);
+
 /**
  * @brief Prompt for an ID, BFS-check duplicates, then insert into BST.
  * @param owner pointer to the Owner
@@ -439,12 +972,79 @@ void evolvePokemon(OwnerNode *owner);
 void addPokemon(OwnerNode *owner);
 
 /**
- * @brief Recursive Helper to free a Pokemon by ID in the BST.
- * @param pokemonInTree pointer to the current PokemonNode
- * @param IDToRelease ID to remove
- * Why we made it: Recursive helper for freeing a Pokemon by ID.
+ * @brief Add one Pokemon to the owner, given by ID, and report the result.
+ * @param owner pointer to the Owner
+ * @param IDToAdd ID to add
+ */
+void addPokemonByID(OwnerNode *owner, int IDToAdd);
+
+/**
+ * @brief Prompt for a list / range of IDs and add them all at once.
+ * @param owner pointer to the Owner
+ * Why we made it: Seeding a trainer with dozens of species in one round trip.
+ */
+void bulkAddPokemon(OwnerNode *owner);
+
+/**
+ * @brief Add every ID of a list, then print one line with how many were added and skipped.
+ * @param owner pointer to the Owner
+ * @param idList IDs and ranges as accepted by parseSpeciesList
+ */
+void bulkAddPokemonByIDs(OwnerNode *owner, const char *idList);
+
+/**
+ * @brief O(1) lookup of a Pokemon in an owner's Pokedex through the ID index.
+ * @param owner pointer to the Owner
+ * @param id ID to find (out-of-range IDs are simply not found)
+ * @return pointer to the node in the owner's BST or NULL
+ * Why we made it: Fight/evolve/add/release only need membership, not a tree walk.
+ */
+PokemonNode *findPokemonInOwner(OwnerNode *owner, int id);
+
+/**
+ * @brief Add a Pokemon to an owner's BST and ID index.
+ * @param owner pointer to the Owner
+ * @param id ID to add
+ * @return 1 if added, 0 if already present, -1 if the ID is invalid
+ * Why we made it: Single entry point that keeps the BST and the index in sync.
+ */
+int addPokemonToOwner(OwnerNode *owner, int id);
+
+/**
+ * @brief Release an owned Pokemon from an owner's BST and ID index (prints what it removed).
+ * @param owner pointer to the Owner
+ * @param id ID to release (must be owned)
+ * Why we made it: Single entry point that keeps the BST, the index and the arena in sync.
  */
-void freePokemonHelper(PokemonNode **pokemonInTree, int IDToRelease);
+void releasePokemonFromOwner(OwnerNode *owner, int id);
+
+/**
+ * @brief Move every Pokemon of source into target (sorted union + balanced rebuild).
+ * @param target owner that keeps the union
+ * @param source owner whose Pokedex is consumed (left empty)
+ * Why we made it: O(n+m) merge with no per-node queue allocations.
+ */
+void mergeOwnerPokedexes(OwnerNode *target, OwnerNode *source);
+
+/**
+ * @brief Give an owner every species in the mask it doesn't have yet.
+ * @param owner pointer to the Owner
+ * @param mask species to add (ones already held are skipped)
+ * @return number of Pokemon added
+ * Why we made it: New nodes come out of the mask already sorted, so one linear merge with the
+ *                 owner's in-order nodes and a balanced rebuild replace an insert per ID.
+ */
+int addSpeciesMaskToOwner(OwnerNode *owner, const SpeciesMask *mask);
+
+/**
+ * @brief OR the held masks of many owners together.
+ * @param owners owners to combine
+ * @param count number of owners
+ * @param result out: every species held by at least one of them
+ * Why we made it: Large owner lists are split over up to BULK_MERGE_THREADS threads, and the
+ *                 partial masks are combined pairwise like a tree.
+ */
+void unionHeldMasks(OwnerNode *const *owners, int count, SpeciesMask *result);
 
 /**
  * @brief Prompt for ID, remove that Pokemon from BST by ID.
@@ -453,6 +1053,13 @@ void freePokemonHelper(PokemonNode **pokemonInTree, int IDToRelease);
  */
 void freePokemon(OwnerNode *owner);
 
+/**
+ * @brief Release one Pokemon of the owner, given by ID, and report the result.
+ * @param owner pointer to the Owner
+ * @param choiceOfIDToFree ID to release
+ */
+void releasePokemonByID(OwnerNode *owner, int choiceOfIDToFree);
+
 /* ------------------------------------------------------------
    7) Display Menu for a Pokedex
    ------------------------------------------------------------ */
@@ -464,50 +1071,147 @@ void freePokemon(OwnerNode *owner);
  */
 void displayMenu(OwnerNode *owner);
 
+/**
+ * @brief Print the owner's Pokedex in one of the display menu's orders.
+ * @param owner pointer to Owner (non-empty Pokedex)
+ * @param choice display menu option
+ * Why we made it: The menu reads the choice, this does the printing (also used by the server).
+ */
+void displayPokedexAs(OwnerNode *owner, int choice);
+
 /* ------------------------------------------------------------
-   8) Sorting Owners (Bubble Sort on Circular List)
+   8) Sorting Owners (Merge Sort on Circular List)
    ------------------------------------------------------------ */
 
 /**
- * @brief Sort the circular owners list by name.
+ * @brief Sort the circular owners list by name (stable, relinks nodes, head = smallest name).
  * Why we made it: Another demonstration of pointer manipulation + sorting logic.
  */
 void sortOwners(void);
 
 /**
- * @brief Helper to swap name & pokedexRoot in two OwnerNode.
- * @param a pointer to first owner
- * @param b pointer to second owner
- * Why we made it: Used internally by bubble sort to swap data.
+ * @brief Stable merge sort of a NULL-terminated owner chain linked through next (prev is ignored).
+ * @param head first owner of the chain
+ * @return first owner of the sorted chain
+ * Why we made it: O(n log n) sorting that moves pointers, not owner payloads.
  */
-void swapOwnerData(OwnerNode *a, OwnerNode *b);
+OwnerNode *mergeSortOwnerList(OwnerNode *head);
 
 /* ------------------------------------------------------------
    9) Circular List Linking & Searching
    ------------------------------------------------------------ */
 
 /**
- * @brief Insert a new owner into the circular list. If none exist, it's alone.
+ * @brief Insert a new owner at the end of the circular list (and the registry). If none exist, it's alone.
  * @param newOwner pointer to newly created OwnerNode
  * Why we made it: We need a standard approach to keep the list circular.
  */
 void linkOwnerInCircularList(OwnerNode *newOwner);
 
 /**
- * @brief Remove a specific OwnerNode from the circular list, possibly updating head.
+ * @brief Remove a specific OwnerNode from the circular list (and the registry), possibly updating head.
  * @param target pointer to the OwnerNode
  * Why we made it: Deleting or merging owners requires removing them from the ring.
  */
 void removeOwnerFromCircularList(OwnerNode *target);
 
 /**
- * @brief Find an owner by name in the circular list.
+ * @brief Find an owner by name through the owner registry.
  * @param name string to match
  * @return pointer to the matching OwnerNode or NULL
- * Why we made it: We often need to locate an owner quickly.
+ * Why we made it: We often need to locate an owner quickly (O(1) expected, no ring walk).
  */
 OwnerNode *findOwnerByName(const char *name);
 
+/**
+ * @brief FNV-1a hash of an owner name.
+ * @param name the name
+ * @return 32-bit hash
+ * Why we made it: Bucket selection for the owner registry.
+ */
+unsigned int hashOwnerName(const char *name);
+
+/**
+ * @brief Add an owner to the name registry (grows the table when needed).
+ * @param owner owner whose ownerName is set
+ * Why we made it: Keeps name lookups O(1) as owners are created.
+ */
+void registerOwner(OwnerNode *owner);
+
+/**
+ * @brief Remove an owner from the name registry.
+ * @param owner a registered owner
+ * Why we made it: Deleted/merged owners must stop being findable.
+ */
+void unregisterOwner(OwnerNode *owner);
+
+/**
+ * @brief Free the registry's bucket array and reset it.
+ * Why we made it: Clean exit once all owners are gone.
+ */
+void freeOwnerRegistry(void);
+
+/**
+ * @brief O(1) owner lookup by list number, wrapping like walking the circle.
+ * @param listNumber 1-based number as shown in the owner listing (values below 1 pick the head)
+ * @return the owner, or NULL if there are no owners
+ * Why we made it: Menus select owners by number without walking the ring.
+ */
+OwnerNode *getOwnerByNumber(int listNumber);
+
+/**
+ * @brief Re-derive the owner directory by walking the ring once from ownerHead.
+ * Why we made it: After reordering the whole ring (sort) a fresh pass is simplest.
+ */
+void rebuildOwnerDirectory(void);
+
+/**
+ * @brief Free the owner directory's array and reset it.
+ * Why we made it: Clean exit once all owners are gone.
+ */
+void freeOwnerDirectory(void);
+
+/**
+ * @brief Append the owner to speciesHolders[id] / take it out again (swap with the last holder).
+ * @param owner pointer to the Owner
+ * @param id species ID
+ * Why we made it: O(1) upkeep of the inverted index on every add and release.
+ */
+void addSpeciesHolder(OwnerNode *owner, int id);
+void removeSpeciesHolder(OwnerNode *owner, int id);
+
+/**
+ * @brief Free every holder array of the inverted index.
+ * Why we made it: Clean exit once all owners are gone.
+ */
+void freeSpeciesHolders(void);
+
+/**
+ * @brief Ask for a Pokemon ID and list every owner that has it.
+ * Why we made it: Answered straight from the inverted index, cost grows with the answer only.
+ */
+void findOwnersOfPokemon(void);
+
+/**
+ * @brief List every owner that has the given Pokemon ID.
+ * @param id species ID
+ */
+void printHoldersOf(int id);
+
+/**
+ * @brief Print how many owners hold each species, rarest first, then how many species nobody has.
+ * Why we made it: Rarity at a glance without walking any tree.
+ */
+void printRarityReport(void);
+
+/**
+ * @brief qsort compare: fewer holders first, then lower ID.
+ * @param a pointer to an int species ID
+ * @param b pointer to an int species ID
+ * @return <0, 0, or >0
+ */
+int compareByHolderCount(const void *a, const void *b);
+
 /* ------------------------------------------------------------
    10) Owner Menus
    ------------------------------------------------------------ */
@@ -524,18 +1228,51 @@ void enterExistingPokedexMenu(void);
  */
 void openPokedexMenu(void);
 
+/**
+ * @brief Create a Pokedex for a new owner with the chosen starter, or say why not.
+ * @param ownerName malloc'd name, taken over by the new owner (freed on failure)
+ * @param choice starter option (BULBASAUR_OPT..SQUIRTLE_OPT)
+ */
+void createPokedexFor(char *ownerName, int choice);
+
 /**
  * @brief Delete an entire Pokedex (owner) from the list.
  * Why we made it: Let user pick which Pokedex to remove and free everything.
  */
 void deletePokedex(void);
 
+/**
+ * @brief Delete one owner's entire Pokedex and the owner itself.
+ * @param cur owner to delete
+ */
+void deletePokedexOf(OwnerNode *cur);
+
 /**
  * @brief Merge the second owner's Pokedex into the first, then remove the second owner.
- * Why we made it: BFS copy demonstration plus removing an owner.
+ * Why we made it: Sorted-union merge demonstration plus removing an owner.
  */
 void mergePokedexMenu(void);
 
+/**
+ * @brief Ask for a target owner and a comma-separated list of owners to merge into it.
+ * Why we made it: Consolidating many accounts in one step instead of one merge per pair.
+ */
+void bulkMergePokedexMenu(void);
+
+/**
+ * @brief Merge every listed owner into the target, then remove them all.
+ * @param targetName owner that keeps the union
+ * @param sourceNames comma-separated owner names (modified); missing names, repeats and the target are skipped
+ */
+void bulkMergePokedexesInto(const char *targetName, char *sourceNames);
+
+/**
+ * @brief Merge the second named owner into the first (nothing if either is missing or they're the same).
+ * @param firstUser owner that keeps the union
+ * @param secondUser owner that is removed
+ */
+void mergePokedexesOf(const char *firstUser, const char *secondUser);
+
 /* ------------------------------------------------------------
    11) Printing Owners in a Circle
    ------------------------------------------------------------ */
@@ -546,6 +1283,13 @@ void mergePokedexMenu(void);
  */
 void printOwnersCircular(void);
 
+/**
+ * @brief Print numPrints owners around the ring from the head.
+ * @param forward nonzero to follow next, zero to follow prev
+ * @param numPrints how many to print (nothing if < 1)
+ */
+void printOwnersInDirection(int forward, int numPrints);
+
 /* ------------------------------------------------------------
    11.b) Printing All Owners
    ------------------------------------------------------------ */
@@ -555,6 +1299,22 @@ void printOwnersCircular(void);
  */
 void printAllOwners(void);
 
+/**
+ * @brief Print owners by list number from a given position.
+ * @param first 0-based position of the first owner to print
+ * @param amount how many owners to print at most
+ * Why we made it: Paged listing without walking the ring.
+ */
+void printOwnersPage(int first, int amount);
+
+/**
+ * @brief List owners (a page at a time when there are many) and read the chosen list number.
+ * @param prompt prompt for the number
+ * @return the number entered (0 only advances the page when paging)
+ * Why we made it: Large owner lists shouldn't be dumped in full for every choice.
+ */
+int readOwnerChoice(const char *prompt);
+
 /* ------------------------------------------------------------
    12) Cleanup All Owners at Program End
    ------------------------------------------------------------ */
@@ -566,7 +1326,184 @@ void printAllOwners(void);
 void freeAllOwners(void);
 
 /* ------------------------------------------------------------
-   13) The Main Menu
+   13) Snapshots (Save / Load)
+   ------------------------------------------------------------
+   File layout (all integers little-endian):
+     magic "PKDX" | u32 version | u32 owner count
+     per owner, in ring order: u32 name length | name bytes | SPECIES_MASK_WORDS x u64 held mask
+*/
+
+/**
+ * @brief Give an empty owner every species in the mask, building the tree in one pass.
+ * @param owner owner with an empty Pokedex
+ * @param mask species to add
+ * @return 1 on success, 0 if memory ran out (owner keeps what was built)
+ * Why we made it: Nodes come out of the mask already sorted, so no per-ID inserts are needed.
+ */
+int fillOwnerFromMask(OwnerNode *owner, const SpeciesMask *mask);
+
+/**
+ * @brief Write all owners (names, order, held IDs) to a snapshot file.
+ * @param path file to (over)write; written to path + ".tmp" first, then renamed
+ * @return number of owners saved, or -1 on error
+ * Why we made it: Restoring state no longer means replaying long scripts.
+ */
+int saveSnapshot(const char *path);
+
+/**
+ * @brief Replace all owners with the contents of a snapshot file.
+ * @param path file to read (mapped with mmap)
+ * @return number of owners loaded, or -1 if the file can't be read or isn't a valid snapshot
+ * Why we made it: Restart a large dataset in milliseconds.
+ */
+int loadSnapshot(const char *path);
+
+/**
+ * @brief Ask for a file name and save / load a snapshot.
+ * Why we made it: Menu entry points for saveSnapshot and loadSnapshot.
+ */
+void saveSnapshotMenu(void);
+void loadSnapshotMenu(void);
+
+/**
+ * @brief Save / load a snapshot and report how it went.
+ * @param path snapshot file
+ */
+void saveSnapshotTo(const char *path);
+void loadSnapshotFrom(const char *path);
+
+/* ------------------------------------------------------------
+   14) Mutations + Write-ahead Journal
+   ------------------------------------------------------------
+   Every change to the owners goes through one of the apply* functions below. They do the
+   work (no prompts) and log a journal record, so the menus and the replay share one code path.
+*/
+
+/**
+ * @brief Create an owner with a starter and put it at the end of the ring.
+ * @param ownerName malloc'd name, owned by the new owner on success
+ * @param starterID starter species
+ * @return the new owner, or NULL (name not taken over)
+ */
+OwnerNode *applyOpenOwner(char *ownerName, int starterID);
+
+/**
+ * @brief Add / release / evolve one Pokemon of an owner.
+ * @param owner pointer to the Owner
+ * @param id species ID
+ * @return applyAddPokemon: like addPokemonToOwner; applyReleasePokemon/applyEvolvePokemon: 1 if changed, else 0
+ */
+int applyAddPokemon(OwnerNode *owner, int id);
+int applyReleasePokemon(OwnerNode *owner, int id);
+int applyEvolvePokemon(OwnerNode *owner, int id);
+
+/**
+ * @brief Merge source into target, then remove and free source.
+ * @param target owner that keeps everything
+ * @param source owner that goes away
+ */
+void applyMergeOwners(OwnerNode *target, OwnerNode *source);
+
+/**
+ * @brief Merge many sources into target, then remove and free all of them.
+ * @param target owner that keeps everything
+ * @param sources distinct owners, none of them the target
+ * @param count number of sources
+ * @return 1 if merged, 0 if the journal record could not be made (nothing changed)
+ * Why we made it: One mask reduction, one rebuild of the target and one directory rebuild,
+ *                 however many owners go away.
+ */
+int applyBulkMerge(OwnerNode *target, OwnerNode **sources, int count);
+
+/**
+ * @brief Give an owner every species in the mask it doesn't have yet.
+ * @param owner pointer to the Owner
+ * @param mask species to add
+ * @return number of Pokemon added
+ */
+int applyBulkAdd(OwnerNode *owner, const SpeciesMask *mask);
+
+/**
+ * @brief Unlink and free an owner.
+ * @param owner owner to delete
+ */
+void applyDeleteOwner(OwnerNode *owner);
+
+/**
+ * @brief Sort the ring by name (no-op for 0 or 1 owners).
+ */
+void applySortOwners(void);
+
+/**
+ * @brief Append one record to the journal buffer (nothing when journaling is off or replaying).
+ * @param op record type
+ * @param payload record body
+ * @param length bytes in payload
+ * Why we made it: Records pile up in memory and reach the disk together in commitJournal.
+ */
+void journalRecord(JournalOp op, const unsigned char *payload, size_t length);
+
+/**
+ * @brief Log a JOURNAL_OWNER record with the owner's name and whole Pokedex.
+ * @param owner owner just added to the ring
+ */
+void journalOwner(const OwnerNode *owner);
+
+/**
+ * @brief Write all buffered records and fsync once.
+ * Why we made it: Group commit; called before blocking on input and at exit.
+ */
+void commitJournal(void);
+
+/**
+ * @brief Replay a journal file to rebuild the owners, then keep it open for appending.
+ * @param path journal file (created if missing)
+ * @return number of records replayed, or -1 if the file can't be opened or holds an intact
+ *         record that doesn't apply (the file is then left untouched)
+ * Why we made it: Crash recovery; a damaged tail from a torn write is cut off.
+ */
+int openJournal(const char *path);
+
+/**
+ * @brief Commit, close and free the journal.
+ */
+void closeJournal(void);
+
+/* ------------------------------------------------------------
+   15) Server Mode
+   ------------------------------------------------------------
+   One line per command, the owner name (when needed) always last:
+     NEW <starter 1-3> <name>   LIST   DELETE <name>   MERGE <first>,<second>
+     MERGEALL <target>,<source>,<source>,...
+     SORT   PRINT <F|B> <count>   FIND <id>   RARITY   SAVE <path>   LOAD <path>
+     ADD <id> <name>   BULKADD <ids, e.g. 1-10,25> <name>   RELEASE <id> <name>   FIGHT <id1> <id2> <name>   EVOLVE <id> <name>
+     DISPLAY <1-5> <name>   FILTER <min HP> <min Attack> <name>   BYTYPE <type 1-15> <name>
+     TOURNAMENT <name>   HELP   QUIT
+   Each reply is the text the menus would print, followed by a line holding only ".".
+   A reply is built in memory while the locks are held, so it is a consistent snapshot of the
+   owner(s) it reads; sending it to the client happens after they are released.
+*/
+
+/**
+ * @brief Run one protocol command against the owners, printing the reply to outputSink.
+ * @param line command line (modified while parsing)
+ * @return 1 if the client asked to quit, else 0
+ * Why we made it: The server's only way in: same work functions as the menus, no prompts.
+ */
+int executeServerCommand(char *line);
+
+/**
+ * @brief Listen on a Unix domain socket and serve clients until SIGINT / SIGTERM.
+ * @param socketPath where to create the socket (an old socket there is replaced)
+ * @return 0 after a clean shutdown, -1 if the socket can't be set up
+ * Why we made it: Many operators at once; one poll loop handles the sockets, a worker pool runs
+ *                 the commands in parallel under ringLock and the owner locks, replies go out after
+ *                 every lock is released.
+ */
+int runServer(const char *socketPath);
+
+/* ------------------------------------------------------------
+   16) The Main Menu
    ------------------------------------------------------------ */
 
 /**
@@ -729,4 +1666,17 @@ static const PokemonData pokedex[] = {
     {150, "Mewtwo", PSYCHIC, 106, 110, CANNOT_EVOLVE},
     {151, "Mew", PSYCHIC, 100, 100, CANNOT_EVOLVE}};
 
+// Display line of every species exactly as printPokemonNode prints it (index = ID - 1)
+char speciesLines[AMOUNT_OF_POKEMON][SPECIES_LINE_SIZE];
+size_t speciesLineLength[AMOUNT_OF_POKEMON];
+
+// pokedex[] stats split into columns
+PokedexColumns pokedexColumns;
+
+// Fight score of every species: attack * ATTACK_MODIFIER + hp * HP_MODIFIER (index = ID - 1)
+float speciesScore[AMOUNT_OF_POKEMON];
+
+// Alphabetical position of every species' name among all names (index = ID - 1, rank 0 comes first)
+int speciesNameRank[AMOUNT_OF_POKEMON];
+
 #endif // EX6_H
@@ -0,0 +1,110 @@
+#!/bin/sh
+# Batch scripts with their expected output. Run from anywhere: sh tests/run.sh
+# Every scenario feeds a tests/*.txt script to a fresh build and compares everything
+# it printed with the matching tests/*.expected.
+set -u
+TESTS=$(cd "$(dirname "$0")" && pwd)
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+gcc -Wall -Wextra -Werror -g -std=c99 -pthread "$TESTS/../ex6.c" -o "$WORK/ex6" || exit 1
+cd "$WORK" || exit 1
+failed=0
+
+# compare <name>.out with tests/<name>.expected
+check()
+{
+    if diff -u "$TESTS/$1.expected" "$1.out"; then
+        echo "PASS $1"
+    else
+        echo "FAIL $1"
+        failed=1
+    fi
+}
+
+# batch mode: no menus or prompts, bad input reported, and a quiet stop when the input runs out
+./ex6 --batch < "$TESTS/batch.txt" > batch.out 2>&1
+echo "exit $?" >> batch.out
+check batch
+
+# tournament: every pair fights once; too few Pokemon and an emptied pokedex are refused
+./ex6 --batch < "$TESTS/tournament.txt" > tournament.out 2>&1
+check tournament
+
+# stat filter: combined bounds, type and evolvability; no matches and an unknown type
+./ex6 --batch < "$TESTS/stat_filter.txt" > stat_filter.out 2>&1
+check stat_filter
+
+# display by type: one type in ID order, a type nobody has, an unknown type, and a release
+./ex6 --batch < "$TESTS/by_type.txt" > by_type.out 2>&1
+check by_type
+
+# owner lookup and rarity: no owners yet, one owner, shared species, and after a pokedex is deleted
+./ex6 --batch < "$TESTS/owner_lookup.txt" > owner_lookup.out 2>&1
+check owner_lookup
+
+# snapshot round-trip: one run saves, the next loads and shows the same owners
+./ex6 --batch < "$TESTS/snapshot_save.txt" > snapshot_save.out 2>&1
+check snapshot_save
+./ex6 --batch < "$TESTS/snapshot_load.txt" > snapshot_load.out 2>&1
+check snapshot_load
+
+# journal replay: one run logs its changes, the next starts where it stopped
+./ex6 --batch --journal full.journal < "$TESTS/journal_write.txt" > journal_write.out 2>&1
+check journal_write
+cp full.journal replay.journal
+./ex6 --batch --journal replay.journal < "$TESTS/journal_replay.txt" > journal_replay.out 2>&1
+check journal_replay
+
+# truncated journal: a half-written last record is dropped, the rest replays
+size=$(wc -c < full.journal)
+head -c $((size - 3)) full.journal > truncated.journal
+./ex6 --batch --journal truncated.journal < "$TESTS/journal_replay.txt" > journal_truncated.out 2>&1
+check journal_truncated
+
+# rejected journal: intact records that don't fit the owners stop startup and leave the file alone
+set -- $(od -An -tu1 -N4 full.journal)
+tail -c +$(($1 + $2 * 256 + $3 * 65536 + $4 * 16777216 + 10)) full.journal > rejected.journal
+cp rejected.journal rejected.before
+./ex6 --batch --journal rejected.journal < "$TESTS/journal_replay.txt" > journal_rejected.out 2>&1
+echo "exit $?" >> journal_rejected.out
+cmp -s rejected.journal rejected.before || echo "journal changed" >> journal_rejected.out
+check journal_rejected
+
+# server protocol: one client sends the whole script, then SIGTERM must stop the server cleanly
+if command -v python3 > /dev/null; then
+    ./ex6 --server pokedex.sock 2> server.err &
+    server=$!
+    tries=0
+    while [ ! -S pokedex.sock ] && [ $tries -lt 50 ]; do
+        sleep 0.1
+        tries=$((tries + 1))
+    done
+    python3 -c '
+import socket, sys
+client = socket.socket(socket.AF_UNIX)
+client.connect("pokedex.sock")
+client.sendall(open(sys.argv[1], "rb").read())
+while True:
+    reply = client.recv(65536)
+    if not reply:
+        break
+    sys.stdout.buffer.write(reply)
+' "$TESTS/server.txt" > server.out 2>&1
+    kill -TERM $server
+    wait $server
+    echo "server exit $?" >> server.out
+    [ -e pokedex.sock ] && echo "socket left behind" >> server.out
+    check server
+else
+    echo "SKIP server (needs python3 for the socket client)"
+fi
+
+# merge many: a single owner, unknown and repeated names, the target in its own list, the last other owner
+./ex6 --batch < "$TESTS/bulk_merge.txt" > bulk_merge.out 2>&1
+check bulk_merge
+
+# bulk add: single IDs, ranges, IDs already held, and lists that are rejected whole
+./ex6 --batch < "$TESTS/bulk_add.txt" > bulk_add.out 2>&1
+check bulk_add
+
+exit $failed